@@ -16,6 +16,7 @@ static void glfw_error_callback(int error, const char *description)
 
 int main(int argc, char *argv[])
 {
+    bool startup = false;
     if (argc > 1)
     {
         if (strcmp(argv[1], "-v") == 0 || strcmp(argv[1], "--version") == 0)
@@ -28,10 +29,13 @@ int main(int argc, char *argv[])
             printf("%s\n", GIT_SHA1);
             return 0;
         }
+        if (strcmp(argv[1], "--startup") == 0)
+            startup = true;
     }
 
     State state;
     state.gui.bw.objects.reserve(2048);
+    state.gui.Init();
     state.rng.seed(time(NULL));
 
     glfwSetErrorCallback(glfw_error_callback);
@@ -63,17 +67,26 @@ int main(int argc, char *argv[])
 
     if (glwindow == NULL)
         return 1;
+    utils::StartupPhase("window");
 
     glfwMakeContextCurrent(glwindow);
     glfwSwapInterval(1); // Enable vsync
+    utils::StartupPhase("gl context");
 
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
     
     MainWindowStyle();
 
+    // Built here rather than lazily in the first NewFrame() so the cost is measured on its own
+    bool cached = utils::BuildFontsCached(ImGui::GetIO().Fonts, "imstudio.fontcache");
+    utils::StartupPhase(cached ? "font atlas (hit)" : "font atlas (miss)");
+
     ImGui_ImplGlfw_InitForOpenGL(glwindow, true);
     ImGui_ImplOpenGL3_Init(glsl_version);
+    utils::StartupPhase("backend init");
+
+    bool firstframe = true;
 
     while ((!glfwWindowShouldClose(glwindow)) && (state.gui.state))
     {
@@ -81,8 +94,10 @@ int main(int argc, char *argv[])
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
+        if (firstframe) utils::StartupPhase("device objects");
 
         MainWindowGUI(state);
+        if (firstframe) utils::StartupPhase("first gui");
 
         ImGui::Render();
         int display_w, display_h;
@@ -94,6 +109,12 @@ int main(int argc, char *argv[])
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
         glfwSwapBuffers(glwindow);
+        if (firstframe)
+        {
+            utils::StartupPhase("first present");
+            if (startup) printf("%s\n", utils::StartupReport().c_str());
+            firstframe = false;
+        }
     }
 
     ImGui_ImplOpenGL3_Shutdown();
@@ -18,6 +18,7 @@ int main(int, char **)
 {
     State state;
     state.gui.bw.objects.reserve(2048);
+    state.gui.Init();
     state.rng.seed(time(NULL));
 
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER | SDL_INIT_GAMECONTROLLER) != 0)
@@ -48,14 +49,21 @@ int main(int, char **)
         return 1;
     }
     SDL_GL_SetSwapInterval(1); // Enable vsync
+    utils::StartupPhase("window");
 
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
 
     MainWindowStyle();
 
+    // MEMFS does not outlive the page, so there is nothing to cache the atlas into
+    ImGui::GetIO().Fonts->Build();
+    utils::StartupPhase("font atlas");
+
     ImGui_ImplSDL2_InitForOpenGL(g_Window, g_GLContext);
     ImGui_ImplOpenGL3_Init(glsl_version);
+    JsClipboard_InstallExportHook(); // copies reach the browser when they happen, not every frame
+    utils::StartupPhase("backend init");
 
     /////////////////////////////////////////////////////////
     emscripten_set_main_loop_arg(main_loop, &state, 0, true);
@@ -85,4 +93,11 @@ static void main_loop(void *arg)
     glClear(GL_COLOR_BUFFER_BIT);
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
     SDL_GL_SwapWindow(g_Window);
+
+    static bool firstframe = true;
+    if (firstframe)
+    {
+        utils::StartupPhase("first frame");
+        firstframe = false;
+    }
 }
\ No newline at end of file
@@ -17,6 +17,8 @@
 #include "imgui_internal.h"
 #include "fmt/format.h"
 #include "utils/utils.h"
+#include "utils/FontCache.h"
+#include "utils/FileWatch.h"
 #ifdef __EMSCRIPTEN__
 #include "utils/JsClipboardTricks.h"
 #include "utils/HyperlinkHelper.h"
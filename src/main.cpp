@@ -76,6 +76,8 @@ void MainWindowGUI(State & state)
     ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize);
     ImGui::SetNextWindowBgAlpha(0.00f);
 
+    gui.PollJobs();
+
     // window-menubar
     gui.mb_P = ImVec2(0, 0);
     gui.mb_S = ImVec2(w_w, 46);
@@ -143,9 +145,14 @@ void MainWindowGUI(State & state)
 
         if (gui.child_color) utils::ShowColorExportWindow(&gui.child_color);
 
+        if (gui.child_minimap) gui.ShowMinimap();
+
         if (gui.child_resources) utils::ShowResourcesWindow(&gui.child_resources);
 
         if (gui.child_about) utils::ShowAboutWindow(&gui.child_about);
     }
 
+    // the frame's edits are done: hand the new version to the workers
+    gui.bw.publish();
+
 }
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include "../includes.h"
+#include "atlas.h"
+
+// Our own static copy of the packer: imgui_draw.cpp keeps its instance private to the font atlas
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imstb_rectpack.h"
+
+void ImStudio::Atlas::add(const std::string &source, ImVec2 size)
+{
+    int w = ImMax((int)ceilf(size.x), 1);
+    int h = ImMax((int)ceilf(size.y), 1);
+    auto found = index.find(source);
+    if (found != index.end())
+    {
+        AtlasImage &image = images[found->second];
+        image.w = ImMax(image.w, w);
+        image.h = ImMax(image.h, h);
+        return;
+    }
+    AtlasImage image;
+    image.source = source;
+    image.w      = w;
+    image.h      = h;
+    index[source] = (int)images.size();
+    images.push_back(image);
+}
+
+int ImStudio::Atlas::find(const std::string &source) const
+{
+    auto found = index.find(source);
+    return (found != index.end()) ? found->second : -1;
+}
+
+void ImStudio::Atlas::pack()
+{
+    // start from the smallest page that could hold every cell and the largest image; double it while the images
+    // still spread over several pages, up to the size any GPU can take
+    long long area = 0;
+    pagesize = minpagesize;
+    for (const AtlasImage &image : images)
+    {
+        area += (long long)(image.w + padding) * (image.h + padding);
+        while ((image.w + padding > pagesize) || (image.h + padding > pagesize)) pagesize *= 2;
+    }
+    while ((pagesize < maxpagesize) && ((long long)pagesize * pagesize < area)) pagesize *= 2;
+    while ((packpages() > 1) && (pagesize < maxpagesize)) pagesize *= 2;
+}
+
+int ImStudio::Atlas::packpages()
+{
+    std::vector<stbrp_rect> rects(images.size());
+    for (size_t n = 0; n < images.size(); n++)
+    {
+        rects[n].id = (int)n;
+        rects[n].w  = images[n].w + padding;
+        rects[n].h  = images[n].h + padding;
+    }
+
+    // skyline bottom-left over one page at a time; what did not fit goes on to the next page. Every cell fits an
+    // empty page (see pack()), so each round places at least one.
+    std::vector<stbrp_node> nodes(pagesize);
+    pages = 0;
+    while (!rects.empty())
+    {
+        stbrp_context context;
+        stbrp_init_target(&context, pagesize, pagesize, nodes.data(), (int)nodes.size());
+        stbrp_pack_rects(&context, rects.data(), (int)rects.size());
+
+        size_t left = 0;
+        for (const stbrp_rect &r : rects)
+        {
+            if (!r.was_packed)
+            {
+                rects[left++] = r;
+                continue;
+            }
+            AtlasImage &image = images[r.id];
+            image.page = pages;
+            image.x    = r.x;
+            image.y    = r.y;
+            image.uv0  = ImVec2((float)r.x / pagesize, (float)r.y / pagesize);
+            image.uv1  = ImVec2((float)(r.x + image.w) / pagesize, (float)(r.y + image.h) / pagesize);
+        }
+        rects.resize(left);
+        pages++;
+    }
+    return pages;
+}
+
+void ImStudio::CollectImages(BufferWindow *bw, Atlas *atlas)
+{
+    for (Object &o : bw->objects)
+    {
+        if (o.type == "image") atlas->add(o.value_s, o.size);
+        for (BaseObject &cw : o.child.objects)
+        {
+            if (cw.type == "image") atlas->add(cw.value_s, cw.size);
+        }
+    }
+}
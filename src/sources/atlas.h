@@ -0,0 +1,45 @@
+#pragma once
+
+#include "../includes.h"
+#include "buffer.h"
+
+#include <unordered_map>
+
+namespace ImStudio
+{
+
+    // One distinct image source of a design and its rect in the atlas. The cell has the size the design shows the
+    // image at (the largest, when several widgets share a source); the loader fits the image file into it.
+    struct AtlasImage
+    {
+        std::string             source                     = {};                   // Path, as in the design
+        int                     w                          = 0;                    //-- Cell size
+        int                     h                          = 0;                    //--
+        int                     page                       = 0;                    //--
+        int                     x                          = 0;                    //  | Top left in its page
+        int                     y                          = 0;                    //--
+        ImVec2                  uv0                        = {};                   //-- Texture coordinates
+        ImVec2                  uv1                        = {};                   //--
+    };
+
+    // Every image of a design packed into square pages, so the images of a window share one texture (per page)
+    // and ImGui batches them into one draw call
+    struct Atlas
+    {
+        int                     minpagesize                = 256;                  //-- Page sizes tried, doubling
+        int                     maxpagesize                = 4096;                 //--
+        int                     padding                    = 1;                    // Pixels between cells
+        int                     pagesize                   = 0;                    //-- Result of pack()
+        int                     pages                      = 0;                    //--
+        std::vector<AtlasImage> images                     = {};                   // In design order
+        std::unordered_map<std::string, int> index         = {};                   // source -> images
+
+        void add                (const std::string &source, ImVec2 size);
+        int  find               (const std::string &source) const;                 // -1 if not in the atlas
+        void pack               ();                                                // Fewest pages, then smallest
+        int  packpages          ();                                                // At the current pagesize
+    };
+
+    void CollectImages          (BufferWindow *bw, Atlas *atlas);                  // Image widgets, children included
+
+}
@@ -17,8 +17,17 @@ void ImStudio::BufferWindow::drawall(int *select, int gen_rand)
         ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.26f, 0.59f, 0.98f, 0.40f));
         ImGui::PushStyleColor(ImGuiCol_Border, ImVec4(0.86f, 0.86f, 0.86f, 0.50f));
         ImGui::Begin("buffer", &state);
+        ImVec2 prevsize = size;
         size = ImGui::GetWindowSize();
         pos  = ImGui::GetWindowPos();
+        if (scrollto.x >= 0.0f)
+        {
+            ImGui::SetScrollX(scrollto.x);
+            ImGui::SetScrollY(scrollto.y);
+            scrollto = ImVec2(-1, -1);
+        }
+        scroll = ImVec2(ImGui::GetScrollX(), ImGui::GetScrollY());
+        if ((size.x != prevsize.x) || (size.y != prevsize.y)) events.publish(nullptr, nullptr);
         {
             for (auto i = objects.begin(); i != objects.end(); ++i)
             {
@@ -26,14 +35,32 @@ void ImStudio::BufferWindow::drawall(int *select, int gen_rand)
 
                 if (o.state == false)
                 {
+                    events.publish(&o, nullptr);
                     i = objects.erase(i);
                     break;
                 }
                 else
                 {
-                    if (o.type != "child")
+                    if (o.type == "treenode")
+                    {
+                        if (!o.child.init)
+                        {
+                            current_child = &o;
+                            o.child.init  = true;
+                        }
+
+                        ImVec2 objpos  = o.pos;
+                        ImVec2 objsize = o.size;
+                        bool edited    = o.draw(select, gen_rand, staticlayout);
+                        if (edited || Moved(o, objpos, objsize)) events.publish(&o, nullptr);
+                        o.child.drawtree(o, select, gen_rand, &events);
+                    }
+                    else if (o.type != "child")
                     {
-                        o.draw(select, gen_rand, staticlayout);
+                        ImVec2 objpos  = o.pos;
+                        ImVec2 objsize = o.size;
+                        bool edited    = o.draw(select, gen_rand, staticlayout);
+                        if (edited || Moved(o, objpos, objsize)) events.publish(&o, nullptr);
                     }
                     else
                     {
@@ -43,7 +70,11 @@ void ImStudio::BufferWindow::drawall(int *select, int gen_rand)
                             o.child.init  = true;
                         }
 
-                        o.child.drawall(select, gen_rand, staticlayout);
+                        ImRect rect = o.child.freerect;
+                        o.child.drawall(select, gen_rand, staticlayout, &events);
+                        if ((rect.Min.x != o.child.freerect.Min.x) || (rect.Min.y != o.child.freerect.Min.y) ||
+                            (rect.Max.x != o.child.freerect.Max.x) || (rect.Max.y != o.child.freerect.Max.y))
+                            events.publish(&o, nullptr);
                     }
                 }
             }
@@ -94,6 +125,7 @@ void ImStudio::BufferWindow::create(std::string type_)
     {
         Object widget(idvar, type_);
         objects.push_back(widget);
+        events.publish(&objects.back(), nullptr);
     }
     else
     {
@@ -101,12 +133,94 @@ void ImStudio::BufferWindow::create(std::string type_)
         {
             Object widget(idvar, type_);
             objects.push_back(widget);
+            events.publish(&objects.back(), nullptr);
         }
         else
         {
             BaseObject childwidget(idvar, type_, current_child->id);
             childwidget.parent = current_child;
             current_child->child.objects.push_back(childwidget);
+            events.publish(&current_child->child.objects.back(), nullptr);
         }
     }
 }
+
+namespace
+{
+    using namespace ImStudio;
+
+    ObjectStamp Stamp(const Object &o)
+    {
+        ObjectStamp stamp;
+        stamp.id       = o.id;
+        stamp.revision = o.revision;
+        for (const BaseObject &cw : o.child.objects)
+            stamp.children.push_back(std::make_pair(cw.id, cw.revision));
+        return stamp;
+    }
+
+    // Revisions only grow and ids are never reused, so equal stamps mean the object and its children are unchanged
+    bool SameStamp(const ObjectStamp &a, const Object &o)
+    {
+        if ((a.id != o.id) || (a.revision != o.revision) || (a.children.size() != o.child.objects.size()))
+            return false;
+        for (size_t n = 0; n < a.children.size(); n++)
+            if ((a.children[n].first != o.child.objects[n].id) || (a.children[n].second != o.child.objects[n].revision))
+                return false;
+        return true;
+    }
+}
+
+void ImStudio::DesignSnapshot::materialize(BufferWindow *bw) const
+{
+    bw->size         = size;
+    bw->pos          = pos;
+    bw->idvar        = idvar;
+    bw->staticlayout = staticlayout;
+    bw->objects.clear();
+    bw->objects.reserve(objects.size());
+    for (const std::shared_ptr<const Object> &o : objects)
+        bw->objects.push_back(*o);
+}
+
+void ImStudio::BufferWindow::publish()
+{
+    std::shared_ptr<const DesignSnapshot> prev = std::atomic_load(&published);
+    if (prev && (prev->version == events.revision)) return;
+
+    std::shared_ptr<DesignSnapshot> next = std::make_shared<DesignSnapshot>();
+    next->version      = events.revision;
+    next->size         = size;
+    next->pos          = pos;
+    next->idvar        = idvar;
+    next->staticlayout = staticlayout;
+    next->objects.reserve(objects.size());
+
+    // objects keep their order and new ones are appended, so the previous version is matched in one forward walk
+    std::vector<ObjectStamp> nextstamps;
+    nextstamps.reserve(objects.size());
+    size_t from = 0;
+    for (const Object &o : objects)
+    {
+        size_t k = from;
+        while ((k < stamps.size()) && (stamps[k].id != o.id)) k++;
+        if ((k < stamps.size()) && SameStamp(stamps[k], o))
+        {
+            next->objects.push_back(prev->objects[k]);
+            nextstamps.push_back(std::move(stamps[k]));
+        }
+        else
+        {
+            next->objects.push_back(std::make_shared<const Object>(o));
+            nextstamps.push_back(Stamp(o));
+        }
+        if (k < stamps.size()) from = k + 1;
+    }
+    stamps.swap(nextstamps);
+    std::atomic_store(&published, std::shared_ptr<const DesignSnapshot>(next));
+}
+
+std::shared_ptr<const ImStudio::DesignSnapshot> ImStudio::BufferWindow::snapshot() const
+{
+    return std::atomic_load(&published);
+}
@@ -6,23 +6,56 @@
 namespace ImStudio
 {
 
+  class BufferWindow;
+
+  // Immutable published version of a design, safe to read from any thread. Objects that did not change since the
+  // previous version are shared with it, so a publish only copies what was edited.
+  struct DesignSnapshot
+  {
+      unsigned                version                 = 0;                    // PropertyEvents::revision
+      ImVec2                  size                    = {};                   //
+      ImVec2                  pos                     = {};                   //
+      int                     idvar                   = 0;                    //
+      bool                    staticlayout            = false;                //
+      std::vector<std::shared_ptr<const Object>> objects = {};               //
+
+      void                    materialize             (BufferWindow *bw) const; // Scratch copy for the generator
+  };
+
+  struct ObjectStamp
+  {
+      int                     id                      = 0;                    //--
+      unsigned                revision                = 0;                    //  | Of a published object
+      std::vector<std::pair<int, unsigned>> children  = {};                   //--  and its child widgets
+  };
+
   class BufferWindow
   {
     public:
       bool                    state                   = false;                //
       ImVec2                  size                    = {};                   //
       ImVec2                  pos                     = {};                   //
+      ImVec2                  scroll                  = {};                   //-- Scroll of the window, and one
+      ImVec2                  scrollto                = ImVec2(-1, -1);       //-- to go to (-1 = none)
       int                     idvar                   = 0;                    //
       Object*                 current_child           = nullptr;              //
     
       bool                    staticlayout            = false;                //
     
       std::vector<Object>     objects                 = {};                   //
+      PropertyEvents          events                  = {};                   // Changes to the design
   
       void                    drawall                 (int *select, int gen_rand);
       Object *                getobj                  (int id);
       BaseObject *            getbaseobj              (int id);
       void                    create                  (std::string type_);
+
+      void                    publish                 ();                     // UI thread, end of frame
+      std::shared_ptr<const DesignSnapshot> snapshot  () const;               // Latest version, any thread
+
+    private:
+      std::shared_ptr<const DesignSnapshot> published = nullptr;              // atomic_load/atomic_store only
+      std::vector<ObjectStamp> stamps                 = {};                   // Per published object
   };
 
 }
\ No newline at end of file
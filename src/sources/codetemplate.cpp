@@ -0,0 +1,212 @@
+#include "../includes.h"
+#include "codetemplate.h"
+
+#include <fstream>
+#include <sstream>
+#include <iterator>
+
+namespace
+{
+    const char *fieldnames[ImStudio::TF_COUNT] = {
+        "", "type", "id", "label", "value_s", "value_b", "item_current", "pos.x", "pos.y",
+        "size.x", "size.y", "width", "border", "cursor", "window", "window.w", "window.h"
+    };
+
+    int FindField(const std::string &name)
+    {
+        for (int f = ImStudio::TF_LITERAL + 1; f < ImStudio::TF_COUNT; f++)
+        {
+            if (name == fieldnames[f]) return f;
+        }
+        return -1;
+    }
+
+    // Appends literal text, merged into the previous op when that is a literal too
+    void AddLiteral(ImStudio::TemplateSet *set, const char *text, size_t length)
+    {
+        if (length == 0) return;
+        if (!set->ops.empty() && (set->ops.back().field == ImStudio::TF_LITERAL) &&
+            ((int)set->ops.size() > set->starts.back()))
+        {
+            set->ops.back().length += (unsigned)length;
+        }
+        else
+        {
+            ImStudio::TemplateOp op;
+            op.begin  = (unsigned)set->literals.size();
+            op.length = (unsigned)length;
+            set->ops.push_back(op);
+        }
+        set->literals.append(text, length);
+    }
+}
+
+bool ImStudio::TemplateSet::compile(const std::string &source)
+{
+    TemplateSet set;
+    int    line = 0;
+    size_t pos  = 0;
+    while (pos < source.size())
+    {
+        size_t end  = source.find('\n', pos);
+        size_t next = (end == std::string::npos) ? source.size() : end + 1;
+        if (end == std::string::npos) end = source.size();
+        line++;
+
+        const char *l   = source.c_str() + pos;
+        size_t      len = end - pos;
+        pos = next;
+
+        if ((len >= 2) && (l[0] == '@') && (l[1] == '#'))
+            continue;
+
+        if ((len >= 2) && (l[0] == '@') && (l[1] == '@'))
+        {
+            size_t b = 2, e = len;
+            while ((b < e) && isspace((unsigned char)l[b])) b++;
+            while ((e > b) && isspace((unsigned char)l[e - 1])) e--;
+            std::string name(l + b, e - b);
+            if (name.empty())
+            {
+                error = fmt::format("line {}: section without a name", line);
+                return false;
+            }
+            if (set.find(name) >= 0)
+            {
+                error = fmt::format("line {}: duplicate section \"{}\"", line, name);
+                return false;
+            }
+            set.names.push_back(name);
+            set.starts.push_back((int)set.ops.size());
+            continue;
+        }
+
+        if (set.names.empty())
+        {
+            for (size_t i = 0; i < len; i++)
+            {
+                if (!isspace((unsigned char)l[i]))
+                {
+                    error = fmt::format("line {}: text before the first \"@@\" section", line);
+                    return false;
+                }
+            }
+            continue;
+        }
+
+        // body line, including its newline
+        size_t body = (next - (l - source.c_str()));
+        size_t lit  = 0;
+        for (size_t i = 0; i < body; i++)
+        {
+            if (l[i] != '$') continue;
+            AddLiteral(&set, l + lit, i - lit);
+            if ((i + 1 < body) && (l[i + 1] == '$'))
+            {
+                AddLiteral(&set, "$", 1);
+                lit = i + 2;
+                i++;
+                continue;
+            }
+            size_t close = (i + 1 < body) && (l[i + 1] == '(') ? std::string(l + i, body - i).find(')') : std::string::npos;
+            if (close == std::string::npos)
+            {
+                error = fmt::format("line {}: expected \"$(field)\" or \"$$\"", line);
+                return false;
+            }
+            std::string name(l + i + 2, close - 2);
+            int field = FindField(name);
+            if (field < 0)
+            {
+                error = fmt::format("line {}: unknown field \"{}\"", line, name);
+                return false;
+            }
+            TemplateOp op;
+            op.field = field;
+            set.ops.push_back(op);
+            lit = i + close + 1;
+            i   = lit - 1;
+        }
+        AddLiteral(&set, l + lit, body - lit);
+    }
+    set.starts.push_back((int)set.ops.size());
+    set.prologue = set.find("prologue");
+    set.epilogue = set.find("epilogue");
+    if ((set.prologue < 0) != (set.epilogue < 0))
+    {
+        error = "\"prologue\" and \"epilogue\" must be defined together";
+        return false;
+    }
+
+    *this = set;
+    return true;
+}
+
+bool ImStudio::TemplateSet::load(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        error = fmt::format("cannot open {}", path);
+        return false;
+    }
+    std::stringstream source;
+    source << file.rdbuf();
+    return compile(source.str());
+}
+
+int ImStudio::TemplateSet::find(const std::string &name) const
+{
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        if (names[i] == name) return (int)i;
+    }
+    return -1;
+}
+
+void ImStudio::TemplateSet::emit(int section, const TemplateArgs &args, std::string* output) const
+{
+    ImVec2 pos, size;
+    int    id = 0;
+    if (args.child)
+    {
+        pos  = args.child->freerect.Min;
+        size = args.child->freerect.GetSize();
+        id   = args.child->id;
+    }
+    else if (args.obj)
+    {
+        pos  = args.obj->pos;
+        size = args.obj->size;
+        id   = args.obj->id;
+    }
+
+    auto out = std::back_inserter(*output);
+    for (int i = starts[section]; i < starts[section + 1]; i++)
+    {
+        const TemplateOp &op = ops[i];
+        switch (op.field)
+        {
+        case TF_LITERAL:      output->append(literals, op.begin, op.length); break;
+        case TF_TYPE:         if (args.obj) *output += args.obj->type; break;
+        case TF_ID:           fmt::format_to(out, "{}", id); break;
+        case TF_LABEL:        if (args.obj) *output += args.obj->label; break;
+        case TF_VALUE_S:      if (args.obj) *output += args.obj->value_s; break;
+        case TF_VALUE_B:      if (args.obj) *output += args.obj->value_b ? "true" : "false"; break;
+        case TF_ITEM_CURRENT: if (args.obj) fmt::format_to(out, "{}", args.obj->item_current); break;
+        case TF_POS_X:        fmt::format_to(out, "{}", pos.x); break;
+        case TF_POS_Y:        fmt::format_to(out, "{}", pos.y); break;
+        case TF_SIZE_X:       fmt::format_to(out, "{}", size.x); break;
+        case TF_SIZE_Y:       fmt::format_to(out, "{}", size.y); break;
+        case TF_WIDTH:        if (args.obj) fmt::format_to(out, "{}", args.obj->width); break;
+        case TF_BORDER:       if (args.child) *output += args.child->border ? "true" : "false"; break;
+        case TF_CURSOR:
+            if (!args.staticlayout && (args.obj || args.child))
+                fmt::format_to(out, "\tImGui::SetCursorPos(ImVec2({},{}));\n", pos.x, pos.y);
+            break;
+        case TF_WINDOW:       *output += args.window; break;
+        case TF_WINDOW_W:     fmt::format_to(out, "{}", args.windowsize.x); break;
+        case TF_WINDOW_H:     fmt::format_to(out, "{}", args.windowsize.y); break;
+        }
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "../includes.h"
+#include "object.h"
+
+// User code templates
+//
+// A template file is a list of sections. A section starts with a line "@@ <name>" and its body is every
+// following line up to the next "@@" line, copied verbatim. <name> is a widget type ("button", "checkbox",
+// ...), "child"/"endchild" for child containers, or "prologue"/"epilogue" (both or neither) for the window
+// around the widgets.
+// Lines starting with "@#" are comments. Inside a body, "$(field)" is replaced by a widget/window field and
+// "$$" is a literal '$'. Kinds without a section keep the built-in output.
+//
+//   @@ checkbox
+//   $(cursor)	static bool c$(id) = $(value_b);
+//   	ImGui::Checkbox("$(label)", &c$(id));
+//
+// Fields: type id label value_s value_b item_current pos.x pos.y size.x size.y width border cursor
+//         window window.w window.h
+// ("cursor" is the SetCursorPos line in free layout and empty in static layout, "border" is for children)
+
+namespace ImStudio
+{
+
+    enum TemplateField
+    {
+        TF_LITERAL,
+        TF_TYPE,
+        TF_ID,
+        TF_LABEL,
+        TF_VALUE_S,
+        TF_VALUE_B,
+        TF_ITEM_CURRENT,
+        TF_POS_X,
+        TF_POS_Y,
+        TF_SIZE_X,
+        TF_SIZE_Y,
+        TF_WIDTH,
+        TF_BORDER,
+        TF_CURSOR,
+        TF_WINDOW,
+        TF_WINDOW_W,
+        TF_WINDOW_H,
+        TF_COUNT
+    };
+
+    struct TemplateOp
+    {
+        int                     field                      = TF_LITERAL;           // TemplateField
+        unsigned                begin                      = 0;                    //--
+        unsigned                length                     = 0;                    //  | Literal slice of TemplateSet::literals
+    };
+
+    struct TemplateArgs
+    {
+        const BaseObject *      obj                        = nullptr;              // Widget sections
+        const ContainerChild *  child                      = nullptr;              // child/endchild sections
+        const char *            window                     = "";                   // Window name
+        ImVec2                  windowsize                 = {};                   // Window size
+        bool                    staticlayout               = false;                // Static/linear layout
+    };
+
+    struct TemplateSet
+    {
+        std::string             literals                   = {};                   // All literal text
+        std::vector<TemplateOp> ops                        = {};                   // All sections, back to back
+        std::vector<int>        starts                     = {};                   // First op per section, + end sentinel
+        std::vector<std::string> names                     = {};                   // Section names
+        int                     prologue                   = -1;                   //--
+        int                     epilogue                   = -1;                   //  | Window sections
+        std::string             error                      = {};                   // Last compile error
+
+        bool                    compile                    (const std::string &source);
+        bool                    load                       (const std::string &path);
+        int                     find                       (const std::string &name) const;
+        void                    emit                       (int section, const TemplateArgs &args, std::string* output) const;
+    };
+
+}
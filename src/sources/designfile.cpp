@@ -0,0 +1,496 @@
+#include "../includes.h"
+#include "designfile.h"
+
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace
+{
+    using namespace ImStudio;
+
+    const char *header = "imstudio-design 1";
+
+    void Escape(std::string *out, const std::string &text)
+    {
+        for (char c : text)
+        {
+            if      (c == '\\') *out += "\\\\";
+            else if (c == '\t') *out += "\\t";
+            else if (c == '\n') *out += "\\n";
+            else if (c == '\r') *out += "\\r";
+            else                *out += c;
+        }
+    }
+
+    std::string Unescape(const std::string &text)
+    {
+        std::string out;
+        out.reserve(text.size());
+        for (size_t n = 0; n < text.size(); n++)
+        {
+            if ((text[n] != '\\') || (n + 1 == text.size()))
+            {
+                out += text[n];
+                continue;
+            }
+            char c = text[++n];
+            out += (c == 't') ? '\t' : (c == 'n') ? '\n' : (c == 'r') ? '\r' : c;
+        }
+        return out;
+    }
+
+    void Field(std::string *out, const char *key, const std::string &value)
+    {
+        *out += '\t';
+        *out += key;
+        *out += '=';
+        Escape(out, value);
+    }
+
+    void Field(std::string *out, const char *key, ImVec2 v)
+    {
+        *out += fmt::format("\t{}={},{}", key, v.x, v.y);
+    }
+
+    template <typename T> void Field(std::string *out, const char *key, T value)
+    {
+        *out += fmt::format("\t{}={}", key, value);
+    }
+
+    void SaveWidget(std::string *out, const char *kind, const BaseObject &o)
+    {
+        *out += kind;
+        Field(out, "id", o.id);
+        Field(out, "type", o.type);
+        Field(out, "pos", o.pos);
+        Field(out, "size", o.size);
+        Field(out, "width", o.width);
+        Field(out, "label", o.label);
+        Field(out, "value", o.value_s);
+        Field(out, "checked", (int)o.value_b);
+        Field(out, "item", o.item_current);
+        Field(out, "locked", (int)o.locked);
+        Field(out, "center", (int)o.center_h);
+        Field(out, "autoresize", (int)o.autoresize);
+        Field(out, "animate", (int)o.animate);
+        if ((o.type == "combo") || (o.type == "listbox"))
+            Field(out, "items", o.itemlist.text);
+        if (!o.binding.empty())
+            Field(out, "bind", o.binding);
+        *out += '\n';
+    }
+
+    // Everything a design file keeps of one object; equal text means equal saved state
+    std::string SaveObject(const Object &o)
+    {
+        std::string out;
+        SaveWidget(&out, "object", o);
+        if (o.type == "child")
+        {
+            out += "child";
+            Field(&out, "open", (int)o.child.open);
+            Field(&out, "border", (int)o.child.border);
+            Field(&out, "locked", (int)o.child.locked);
+            Field(&out, "min", o.child.grab1);
+            Field(&out, "max", o.child.grab2);
+            out += '\n';
+        }
+        for (const BaseObject &cw : o.child.objects) // child windows and tree nodes
+            SaveWidget(&out, "widget", cw);
+        return out;
+    }
+
+    typedef std::vector<std::pair<std::string, std::string>> Fields;
+
+    Fields SplitFields(const std::string &line, std::string *kind)
+    {
+        Fields fields;
+        size_t at = line.find('\t');
+        *kind = line.substr(0, at);
+        while (at != std::string::npos)
+        {
+            size_t next = line.find('\t', at + 1);
+            std::string field = line.substr(at + 1, (next == std::string::npos) ? std::string::npos : next - at - 1);
+            size_t eq = field.find('=');
+            if (eq != std::string::npos)
+                fields.push_back(std::make_pair(field.substr(0, eq), Unescape(field.substr(eq + 1))));
+            at = next;
+        }
+        return fields;
+    }
+
+    const std::string *Find(const Fields &fields, const char *key)
+    {
+        for (const std::pair<std::string, std::string> &f : fields)
+            if (f.first == key) return &f.second;
+        return nullptr;
+    }
+
+    void Read(const Fields &fields, const char *key, std::string *value)
+    {
+        if (const std::string *v = Find(fields, key)) *value = *v;
+    }
+
+    void Read(const Fields &fields, const char *key, float *value)
+    {
+        if (const std::string *v = Find(fields, key)) *value = strtof(v->c_str(), nullptr);
+    }
+
+    void Read(const Fields &fields, const char *key, int *value)
+    {
+        if (const std::string *v = Find(fields, key)) *value = (int)strtol(v->c_str(), nullptr, 10);
+    }
+
+    void Read(const Fields &fields, const char *key, bool *value)
+    {
+        if (const std::string *v = Find(fields, key)) *value = (*v != "0");
+    }
+
+    void Read(const Fields &fields, const char *key, ImVec2 *value)
+    {
+        const std::string *v = Find(fields, key);
+        if (!v) return;
+        char *end = nullptr;
+        value->x  = strtof(v->c_str(), &end);
+        value->y  = (*end == ',') ? strtof(end + 1, nullptr) : value->y;
+    }
+
+    void ReadWidget(const Fields &fields, BaseObject *o)
+    {
+        Read(fields, "pos", &o->pos);
+        Read(fields, "size", &o->size);
+        Read(fields, "width", &o->width);
+        Read(fields, "label", &o->label);
+        Read(fields, "value", &o->value_s);
+        Read(fields, "checked", &o->value_b);
+        Read(fields, "item", &o->item_current);
+        Read(fields, "locked", &o->locked);
+        Read(fields, "center", &o->center_h);
+        Read(fields, "autoresize", &o->autoresize);
+        Read(fields, "animate", &o->animate);
+        Read(fields, "bind", &o->binding);
+        if (Find(fields, "items"))
+        {
+            Read(fields, "items", &o->itemlist.text);
+            o->itemlist.index();
+        }
+        o->selectinit = false; // loading must not move the selection to the newest object
+    }
+
+    int MaxId(const Object &o)
+    {
+        int id = o.id;
+        for (const BaseObject &cw : o.child.objects)
+            id = std::max(id, cw.id);
+        return id;
+    }
+}
+
+std::string ImStudio::SaveDesign(const DesignSnapshot &design, DesignBase *base)
+{
+    std::string out = header;
+    out += "\nwindow";
+    Field(&out, "size", design.size);
+    Field(&out, "static", (int)design.staticlayout);
+    out += '\n';
+    if (base) base->clear();
+    for (const std::shared_ptr<const Object> &o : design.objects)
+    {
+        std::string record = SaveObject(*o);
+        out += record;
+        if (base) (*base)[o->id] = std::move(record);
+    }
+    return out;
+}
+
+bool ImStudio::ParseDesign(const std::string &text, DesignFile *file, std::string *error)
+{
+    *file = DesignFile();
+    std::istringstream in(text);
+    std::string line;
+    int         number = 0;
+    while (std::getline(in, line))
+    {
+        number++;
+        if (!line.empty() && (line.back() == '\r')) line.pop_back();
+        if (number == 1)
+        {
+            if (line == header) continue;
+            *error = fmt::format("Not an ImStudio design (expected \"{}\")", header);
+            return false;
+        }
+        if (line.empty() || (line[0] == '#')) continue;
+
+        std::string kind;
+        Fields      fields = SplitFields(line, &kind);
+        if (kind == "window")
+        {
+            Read(fields, "size", &file->size);
+            Read(fields, "static", &file->staticlayout);
+        }
+        else if (kind == "object")
+        {
+            int         id = 0;
+            std::string type;
+            Read(fields, "id", &id);
+            Read(fields, "type", &type);
+            if ((id <= 0) || type.empty())
+            {
+                *error = fmt::format("Line {}: object needs an id and a type", number);
+                return false;
+            }
+            DesignRecord record;
+            record.object = Object(id, type);
+            ReadWidget(fields, &record.object);
+            file->records.push_back(std::move(record));
+        }
+        else if ((kind == "child") || (kind == "widget"))
+        {
+            const std::string parent = file->records.empty() ? std::string() : file->records.back().object.type;
+            if ((kind == "child") ? (parent != "child") : !IsContainer(parent))
+            {
+                *error = fmt::format("Line {}: \"{}\" outside of a {}", number, kind,
+                                     (kind == "child") ? "child object" : "child object or tree node");
+                return false;
+            }
+            Object &o = file->records.back().object;
+            if (kind == "child")
+            {
+                Read(fields, "open", &o.child.open);
+                Read(fields, "border", &o.child.border);
+                Read(fields, "locked", &o.child.locked);
+                Read(fields, "min", &o.child.grab1);
+                Read(fields, "max", &o.child.grab2);
+                continue;
+            }
+            int         id = 0;
+            std::string type;
+            Read(fields, "id", &id);
+            Read(fields, "type", &type);
+            if ((id <= 0) || type.empty())
+            {
+                *error = fmt::format("Line {}: widget needs an id and a type", number);
+                return false;
+            }
+            BaseObject cw(id, type, o.id);
+            ReadWidget(fields, &cw);
+            o.child.objects.push_back(cw);
+        }
+        else
+        {
+            *error = fmt::format("Line {}: unknown record \"{}\"", number, kind);
+            return false;
+        }
+    }
+    if (number == 0)
+    {
+        *error = "Empty design file";
+        return false;
+    }
+    for (DesignRecord &record : file->records)
+        record.text = SaveObject(record.object);
+    return true;
+}
+
+void ImStudio::DiffDesign(DesignFile *file, const DesignSnapshot &design, const DesignBase *base, DesignPatch *patch)
+{
+    *patch              = DesignPatch();
+    patch->base         = design.version;
+    patch->size         = file->size;
+    patch->staticlayout = file->staticlayout;
+    patch->window       = (file->size.x != design.size.x) || (file->size.y != design.size.y) ||
+                          (file->staticlayout != design.staticlayout);
+
+    std::unordered_map<int, size_t> published;
+    published.reserve(design.objects.size());
+    for (size_t n = 0; n < design.objects.size(); n++)
+        published[design.objects[n]->id] = n;
+
+    std::unordered_set<int> kept;
+    kept.reserve(file->records.size());
+    for (DesignRecord &record : file->records)
+    {
+        int id = record.object.id;
+        kept.insert(id);
+        if (base)
+        {
+            auto was = base->find(id);
+            if ((was != base->end()) && (was->second == record.text))
+            {
+                patch->unchanged++; // the file did not touch it, whatever the user did since
+                continue;
+            }
+        }
+        auto found = published.find(id);
+        if ((found != published.end()) && (SaveObject(*design.objects[found->second]) == record.text))
+        {
+            patch->unchanged++;
+            continue;
+        }
+        patch->changed.push_back(std::move(record.object));
+    }
+
+    // without a base (first open) the file replaces the design, with one only what the file dropped goes
+    if (base)
+    {
+        for (const std::pair<const int, std::string> &was : *base)
+            if (!kept.count(was.first) && published.count(was.first)) patch->removed.push_back(was.first);
+    }
+    else
+    {
+        for (const std::shared_ptr<const Object> &o : design.objects)
+            if (!kept.count(o->id)) patch->removed.push_back(o->id);
+    }
+}
+
+// The file wins for the objects it changed, local edits to the others are kept. Existing objects stay in place (so
+// the selection does too) and new ones are appended in file order.
+int ImStudio::ApplyDesign(BufferWindow *bw, DesignPatch *patch)
+{
+    int touched = 0;
+    if (patch->window)
+    {
+        bw->size         = patch->size;
+        bw->staticlayout = patch->staticlayout;
+        bw->events.publish(nullptr, nullptr);
+    }
+
+    // one pass over the design, looking up only the ids the patch names
+    const size_t npos = std::string::npos;
+    int current = bw->current_child ? bw->current_child->id : 0;
+    std::unordered_map<int, size_t> index;
+    index.reserve(patch->changed.size() + patch->removed.size() + 1);
+    for (const Object &o : patch->changed) index[o.id] = npos;
+    for (int id : patch->removed) index[id] = npos;
+    if (current) index[current] = npos;
+    for (size_t n = 0; n < bw->objects.size(); n++)
+    {
+        auto found = index.find(bw->objects[n].id);
+        if (found != index.end()) found->second = n;
+    }
+
+    std::unordered_set<int> patched;
+    patched.reserve(patch->changed.size());
+    for (Object &src : patch->changed)
+    {
+        int id     = src.id;
+        bw->idvar  = std::max(bw->idvar, MaxId(src));
+        auto found = index.find(id);
+        if (found->second == npos)
+        {
+            found->second = bw->objects.size();
+            bw->objects.push_back(std::move(src));
+        }
+        else
+        {
+            // keep what only the running editor owns: init flags, grab button ids and the revision
+            Object &dst  = bw->objects[found->second];
+            Object  keep = std::move(dst);
+            dst          = std::move(src);
+            dst.revision       = keep.revision;
+            dst.init           = keep.init;
+            dst.propinit       = keep.propinit;
+            dst.child.init     = keep.child.init;
+            dst.child.grabinit = keep.child.grabinit;
+            dst.child.grab1_id = keep.child.grab1_id;
+            dst.child.grab2_id = keep.child.grab2_id;
+        }
+        patched.insert(id);
+    }
+
+    // the listeners hear of each removed object while it is still in place, then they all go in one pass
+    std::unordered_set<int> removed;
+    removed.reserve(patch->removed.size());
+    for (int id : patch->removed)
+    {
+        size_t at = index[id];
+        if (at == npos) continue;
+        Object &o = bw->objects[at];
+        o.del();
+        bw->events.publish(&o, nullptr);
+        removed.insert(id);
+        touched++;
+    }
+    if (!removed.empty())
+    {
+        bw->objects.erase(std::remove_if(bw->objects.begin(), bw->objects.end(),
+                                         [&removed](const Object &o) { return removed.count(o.id) != 0; }),
+                          bw->objects.end());
+    }
+
+    // pointers into objects only now, the appends and the erase above may have moved them
+    bw->current_child = nullptr;
+    for (Object &o : bw->objects)
+    {
+        o.parent = &o;
+        for (BaseObject &cw : o.child.objects)
+            cw.parent = &o;
+        if (current && (o.id == current)) bw->current_child = &o;
+        if (patched.count(o.id))
+        {
+            bw->events.publish(&o, nullptr);
+            touched++;
+        }
+    }
+    return touched;
+}
+
+bool ImStudio::WriteDesign(const std::string &path, const std::string &text)
+{
+    // written next to the target and renamed over it, so a watcher never reads half a file
+    std::string tmp = path + ".tmp";
+    FILE *fp = fopen(tmp.c_str(), "wb");
+    if (!fp) return false;
+    bool ok = fwrite(text.data(), 1, text.size(), fp) == text.size();
+    ok = (fclose(fp) == 0) && ok;
+#ifdef _WIN32
+    if (ok) remove(path.c_str());
+#endif
+    ok = ok && (rename(tmp.c_str(), path.c_str()) == 0);
+    if (!ok) remove(tmp.c_str());
+    return ok;
+}
+
+bool ImStudio::ReadDesign(const std::string &path, std::string *text)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::stringstream ss;
+    ss << in.rdbuf();
+    *text = ss.str();
+    return true;
+}
+
+ImStudio::DesignIO ImStudio::LoadDesign(const std::string &path, const DesignSnapshot &design, const DesignBase *base)
+{
+    DesignIO    io;
+    std::string text;
+    DesignFile  file;
+    if (!ReadDesign(path, &text))
+    {
+        io.error = fmt::format("Could not read {}", path);
+        return io;
+    }
+    if (!ParseDesign(text, &file, &io.error)) return io;
+
+    std::shared_ptr<DesignBase> next = std::make_shared<DesignBase>();
+    next->reserve(file.records.size());
+    for (const DesignRecord &record : file.records)
+        (*next)[record.object.id] = record.text;
+    DiffDesign(&file, design, base, &io.patch);
+    io.base = next;
+    io.ok   = true;
+    return io;
+}
+
+ImStudio::DesignIO ImStudio::StoreDesign(const std::string &path, const DesignSnapshot &design)
+{
+    DesignIO io;
+    std::shared_ptr<DesignBase> base = std::make_shared<DesignBase>();
+    io.ok    = WriteDesign(path, SaveDesign(design, base.get()));
+    io.error = io.ok ? std::string() : fmt::format("Could not write {}", path);
+    io.base  = base;
+    return io;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "../includes.h"
+#include "object.h"
+#include "buffer.h"
+
+#include <unordered_map>
+
+namespace ImStudio
+{
+
+    // Text design file: a header line, one "window" line, then per object an "object" line followed by its "child"
+    // (child window) and "widget" (widget of a child window or tree node) lines. Fields are tab separated key=value
+    // pairs with backslash escapes for tabs, newlines and backslashes, so scripts can write and patch designs line
+    // by line.
+    struct DesignRecord
+    {
+        Object                  object                     = Object(0, "");        // Parsed object + child widgets
+        std::string             text                       = {};                   // Its lines, as SaveDesign writes them
+    };
+
+    struct DesignFile
+    {
+        ImVec2                  size                       = {};                   //-- Window
+        bool                    staticlayout               = false;                //--
+        std::vector<DesignRecord> records                  = {};                   // In file order
+    };
+
+    // What a file changes relative to one published version of the design
+    struct DesignPatch
+    {
+        unsigned                base                       = 0;                    // DesignSnapshot::version diffed against
+        bool                    window                     = false;                //--
+        ImVec2                  size                       = {};                   //  | Window changed
+        bool                    staticlayout               = false;                //--
+        std::vector<Object>     changed                    = {};                   // New or different objects, file order
+        std::vector<int>        removed                    = {};                   // Objects the file dropped
+        int                     unchanged                  = 0;                    // Objects left alone
+    };
+
+    // Records of the file as last read or written (object id -> text). Diffing against it tells what the file
+    // changed from what the user changed since, so a reload does not undo local edits.
+    typedef std::unordered_map<int, std::string> DesignBase;
+
+    // Result of reading or writing a design file
+    struct DesignIO
+    {
+        bool                    ok                         = false;                //
+        std::string             error                      = {};                   // When !ok
+        DesignPatch             patch                      = {};                   // Read only
+        std::shared_ptr<const DesignBase> base             = nullptr;              // Records now in the file
+    };
+
+    std::string SaveDesign      (const DesignSnapshot &design, DesignBase *base = nullptr);
+    bool        ParseDesign     (const std::string &text, DesignFile *file, std::string *error);
+    void        DiffDesign      (DesignFile *file, const DesignSnapshot &design, const DesignBase *base, DesignPatch *patch);
+    int         ApplyDesign     (BufferWindow *bw, DesignPatch *patch);            // UI thread, returns objects touched
+    bool        WriteDesign     (const std::string &path, const std::string &text);
+    bool        ReadDesign      (const std::string &path, std::string *text);
+    DesignIO    LoadDesign      (const std::string &path, const DesignSnapshot &design, const DesignBase *base);
+    DesignIO    StoreDesign     (const std::string &path, const DesignSnapshot &design);
+
+}
@@ -3,385 +3,2585 @@
 #include "buffer.h"
 #include "generator.h"
 
-void ImStudio::Recreate(BaseObject obj, std::string* output, bool staticlayout)
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <fstream>
+#include <sstream>
+
+namespace
 {
-    std::string bfs;
+    const char *windowname = "window_name"; // Name of the generated ImGui window
+    const int   cliplist   = 64;            // Combo items from which the generated popup is clipped
 
-    if (obj.type == "button")
+    // Item text as it goes between quotes in C++
+    std::string Escaped(const char *text)
     {
-        if (!staticlayout) {
-        bfs += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",obj.pos.x,obj.pos.y);
+        std::string out;
+        for (; *text; text++)
+        {
+            if      (*text == '\\') out += "\\\\";
+            else if (*text == '"')  out += "\\\"";
+            else if (*text == '\t') out += "\\t";
+            else                    out += *text;
         }
-        bfs += fmt::format("\tImGui::Button(\"{}\", ImVec2({},{})); ",obj.value_s, obj.size.x, obj.size.y);
-        bfs += "//remove size argument (ImVec2) to auto-resize\n\n";
-        
+        return out;
     }
 
-    if (obj.type == "radio")
+    // Initialiser of an items array; long lists wrap, eight items per line
+    std::string ItemsInit(const ImStudio::ItemList &list)
     {
-        if (!staticlayout) {
-        bfs += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",obj.pos.x,obj.pos.y);
+        bool wrap = (list.count() > 8);
+        std::string init = "{";
+        for (int n = 0; n < list.count(); n++)
+        {
+            if (wrap && (n % 8 == 0)) init += "\n\t\t";
+            else if (n > 0)           init += " ";
+            init += "\"" + Escaped(list[n]) + "\"";
+            if (n + 1 < list.count()) init += ",";
         }
-        bfs += fmt::format("\tstatic bool r1{} = false;\n",obj.id);
-        bfs += fmt::format("\tImGui::RadioButton(\"{}\", r1{});\n\n",obj.label, obj.id);
+        init += wrap ? "\n\t}" : "}";
+        return init;
     }
 
-    if (obj.type == "checkbox")
+    std::vector<std::string> ItemStrings(const ImStudio::ItemList &list)
     {
-        if (!staticlayout) {
-        bfs += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",obj.pos.x,obj.pos.y);
-        }
-        bfs += fmt::format("\tstatic bool c1{} = false;\n",obj.id);
-        bfs += fmt::format("\tImGui::Checkbox(\"{}\", &c1{});\n\n",obj.label, obj.id);
+        std::vector<std::string> strings;
+        strings.reserve(list.count());
+        for (int n = 0; n < list.count(); n++)
+            strings.push_back(Escaped(list[n]));
+        return strings;
     }
 
-    if (obj.type == "text")
+    // Combo/ListBox over items[first, first + count) (first < 0: the whole array). ListBox() clips on its own; a
+    // long combo gets a popup that only submits the visible items, where Combo() would submit all of them.
+    std::string ItemsCall(const ImStudio::BaseObject &obj, const std::string &label, const std::string &cur,
+                          const std::string &items, int first, const std::string &count, bool clipped)
     {
-        if (!staticlayout) {
-        bfs += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",obj.pos.x,obj.pos.y);
+        const char *call = (obj.type == "combo") ? "Combo" : "ListBox";
+        if (!clipped)
+        {
+            std::string arg = (first < 0) ? items : fmt::format("&{}[{}]", items, first);
+            return fmt::format("\tImGui::{}({}, &{}, {}, {});\n", call, label, cur, arg, count);
         }
-        bfs += fmt::format("\tImGui::Text(\"{}\");\n\n",obj.value_s);
+        std::string at  = (first < 0) ? items + "[" : fmt::format("{}[{} + ", items, first);
+        std::string text;
+        text += fmt::format("\tif (ImGui::BeginCombo({}, {}{}]))\n\t{{\n", label, at, cur);
+        text += "\t\tImGuiListClipper clipper;\n";
+        text += fmt::format("\t\tclipper.Begin({});\n", count);
+        text += "\t\twhile (clipper.Step())\n";
+        text += "\t\t\tfor (int n = clipper.DisplayStart; n < clipper.DisplayEnd; n++)\n";
+        text += fmt::format("\t\t\t\tif (ImGui::Selectable({}n], n == {})) {} = n;\n", at, cur, cur);
+        text += "\t\tImGui::EndCombo();\n\t}\n";
+        return text;
     }
+}
 
-    if (obj.type == "bullet")
+namespace
+{
+    // Tree node header and its closing, around the designed children (if any). The label is never replaced by a
+    // precomputed ID: TreePush() hashes it into the ID stack of the children.
+    std::string TreeOpen(const ImStudio::BaseObject &obj, ImStudio::GeneratorContext* ctx)
     {
-        if (!staticlayout) {
-        bfs += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",obj.pos.x,obj.pos.y);
-        }
-        bfs += "\tImGui::Bullet();\n\n";
-        
+        return fmt::format("\tif (ImGui::TreeNodeEx({}{}))\n\t{{\n", ImStudio::Literal(ctx, obj.label),
+                           obj.value_b ? ", ImGuiTreeNodeFlags_DefaultOpen" : "");
     }
 
-    if (obj.type == "arrow")
+    std::string TreeClose(const ImStudio::BaseObject &obj, ImStudio::GeneratorContext* ctx)
     {
-        if (!staticlayout) {
-        bfs += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",obj.pos.x,obj.pos.y);
+        std::string text;
+        if (!obj.value_s.empty())
+        {
+            ctx->trees = true;
+            text += fmt::format("\t\t({}).draw(); // lazy children\n", obj.value_s);
         }
-        bfs += "\tImGui::ArrowButton(\"##left\", ImGuiDir_Left);\n";
-        bfs += "\tImGui::SameLine();\n";
-        bfs += "\tImGui::ArrowButton(\"##right\", ImGuiDir_Right);\n\n";
+        text += "\t\tImGui::TreePop();\n\t}\n\n";
+        return text;
     }
+}
+
+ImGuiID ImStudio::WindowSeed(int childid)
+{
+    if (childid == 0)
+        return ImHashStr(windowname);
+    return ImHashStr(fmt::format("{}/{:08X}", windowname, childid).c_str());
+}
 
-    if (obj.type == "combo")
+bool ImStudio::TrailingLabel(const std::string &type)
+{
+    static const char *kinds[] = {"radio", "checkbox", "combo", "listbox", "textinput", "inputint", "inputfloat",
+                                  "inputdouble", "inputscientific", "inputfloat3", "dragint", "dragint100",
+                                  "dragfloat", "dragfloatsmall", "sliderint", "sliderfloat", "sliderfloatlog",
+                                  "sliderangle", "color1", "color2", "color3", "plotlines", "plothistogram"};
+    for (const char *k : kinds)
     {
-        if (!staticlayout) {
-        bfs += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",obj.pos.x,obj.pos.y);
-        }
-        bfs += fmt::format("\tImGui::PushItemWidth({});\n",obj.width);
-        bfs += fmt::format("\tstatic int item_current{} = 0;\n",obj.id);
-        bfs += fmt::format("\tconst char *items{}[] = {{\"Never\", \"Gonna\", \"Give\", \"You\", \"Up\"}};\n",obj.id);
-        bfs += fmt::format("\tImGui::Combo(\"{0}\", &item_current{1}, items{1}, IM_ARRAYSIZE(items{1}));\n",obj.label,obj.id);
-        bfs += "\tImGui::PopItemWidth();\n\n";
+        if (type == k) return true;
     }
+    return false;
+}
+
+std::string ImStudio::VisibleLabel(const std::string &label)
+{
+    size_t hidden = label.find("##");
+    return (hidden == std::string::npos) ? label : label.substr(0, hidden);
+}
 
-    if (obj.type == "listbox")
+// name(.name|[index])*, so "data." + path is a field and nothing else goes into the generated code
+bool ImStudio::IsMemberPath(const std::string &path)
+{
+    auto word = [](char c) { return isalnum((unsigned char)c) || (c == '_'); };
+    size_t n = 0;
+    while (n < path.size())
     {
-        if (!staticlayout) {
-        bfs += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",obj.pos.x,obj.pos.y);
+        if ((n > 0) && (path[n] == '['))
+        {
+            size_t digits = ++n;
+            while ((n < path.size()) && isdigit((unsigned char)path[n])) n++;
+            if ((n == digits) || (n == path.size()) || (path[n] != ']')) return false;
+            n++;
+            continue;
         }
-        bfs += fmt::format("\tImGui::PushItemWidth({});\n",obj.width);
-        bfs += fmt::format("\tstatic int item_current{} = 0;\n",obj.id);
-        bfs += fmt::format("\tconst char *items{}[] = {{\"Never\", \"Gonna\", \"Give\", \"You\", \"Up\"}};\n",obj.id);
-        bfs += fmt::format("\tImGui::ListBox(\"{0}\", &item_current{1}, items{1}, IM_ARRAYSIZE(items{1}));\n",obj.label,obj.id);
-        bfs += "\tImGui::PopItemWidth();\n\n";
+        if ((n > 0) && (path[n++] != '.')) return false;
+        if ((n == path.size()) || !(isalpha((unsigned char)path[n]) || (path[n] == '_'))) return false;
+        while ((n < path.size()) && word(path[n])) n++;
     }
+    return !path.empty();
+}
 
-    if (obj.type == "textinput")
+namespace
+{
+    // Name in "type name[dims] = init"
+    std::string DeclName(const std::string &decl)
     {
-        if (!staticlayout) {
-        bfs += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",obj.pos.x,obj.pos.y);
-        }
-        bfs += fmt::format("\tImGui::PushItemWidth({}); ",obj.width);
-        bfs += "//NOTE: (Push/Pop)ItemWidth is optional\n";
-        //static char str0[128] = "Hello, world!";
-        //ImGui::InputText("input text", str0, IM_ARRAYSIZE(str0));
-        bfs += fmt::format("\tstatic char str{}[128] = \"{}\";\n",obj.id,obj.value_s);
-        bfs += fmt::format("\tImGui::InputText(\"{0}\", str{1}, IM_ARRAYSIZE(str{1}));\n",obj.label,obj.id);
-        bfs += "\tImGui::PopItemWidth();\n\n";
+        size_t namebegin = decl.find(' ') + 1;
+        size_t nameend   = decl.find_first_of("[ ", namebegin);
+        return decl.substr(namebegin, nameend - namebegin);
     }
+}
 
-    if (obj.type == "inputint")
+std::string ImStudio::StateDecl(GeneratorContext* ctx, const std::string &decl)
+{
+    if (!ctx->opts->statestruct)
+        return "\tstatic " + decl + ";\n";
+
+    // the member goes into the state struct, the body binds a local reference to it
+    std::string name = DeclName(decl);
+    ctx->members += "\t" + decl + ";\n";
+    return fmt::format("\tauto &{0} = state.{0};\n", name);
+}
+
+std::string ImStudio::StateVar(GeneratorContext* ctx, const BaseObject &obj, CodeList* code, const std::string &decl)
+{
+    if (IsMemberPath(obj.binding))
     {
-        if (!staticlayout) {
-        bfs += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",obj.pos.x,obj.pos.y);
-        }
-        bfs += fmt::format("\tImGui::PushItemWidth({});\n",obj.width);
-        //static int i0 = 123;
-        //ImGui::InputInt("input int", &i0);
-        bfs += fmt::format("\tstatic int i{} = 123;\n",obj.id);
-        bfs += fmt::format("\tImGui::InputInt(\"{}\", &i{});\n",obj.label,obj.id);
-        bfs += "\tImGui::PopItemWidth();\n\n";
+        ctx->bound = true;
+        return "data." + obj.binding;
     }
+    code->decl(StateDecl(ctx, decl));
+    return DeclName(decl);
+}
 
-    if (obj.type == "inputfloat")
+int ImStudio::StringTable::add(const std::string &text)
+{
+    auto found = index.find(text);
+    if (found != index.end()) return found->second;
+    int n = (int)strings.size();
+    strings.push_back(text);
+    index[text] = n;
+    return n;
+}
+
+int ImStudio::StringTable::addlist(const std::vector<std::string> &list)
+{
+    // a list is only found again as a whole; its strings are stored contiguously so it is passed as &strings[n]
+    std::string key;
+    for (const std::string &text : list)
     {
-        if (!staticlayout) {
-        bfs += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",obj.pos.x,obj.pos.y);
-        }
-        bfs += fmt::format("\tImGui::PushItemWidth({});\n",obj.width);
-        //static float f0 = 0.001f;
-        //ImGui::InputFloat("input float", &f0, 0.01f, 1.0f, "%.3f");
-        bfs += fmt::format("\tstatic float f{} = 0.001f;\n",obj.id);
-        bfs += fmt::format("\tImGui::InputFloat(\"{}\", &f{}, 0.01f, 1.0f, \"%.3f\");\n",obj.label,obj.id);
-        bfs += "\tImGui::PopItemWidth();\n\n";
+        key += text;
+        key += '\0';
+    }
+    auto found = lists.find(key);
+    if (found != lists.end()) return found->second;
+    int n = (int)strings.size();
+    for (const std::string &text : list)
+    {
+        index.insert(std::make_pair(text, (int)strings.size()));
+        strings.push_back(text);
     }
+    lists[key] = n;
+    return n;
+}
 
-    if (obj.type == "inputdouble")
+std::string ImStudio::StringTable::decl(const char *storage) const
+{
+    if (strings.empty()) return std::string();
+    std::string text = "// String table: every label and item list of the window, referenced by index\n";
+    text += fmt::format("{}const char *const strings[] =\n{{\n", storage);
+    for (size_t i = 0; i < strings.size(); i++)
+        text += fmt::format("\t\"{}\", // {}\n", strings[i], i);
+    text += "};\n\n";
+    return text;
+}
+
+std::string ImStudio::Literal(GeneratorContext* ctx, const std::string &text)
+{
+    if (!ctx->opts->stringtable || text.empty())
+        return fmt::format("\"{}\"", text);
+    return fmt::format("strings[{}]", ctx->strings.add(text));
+}
+
+namespace
+{
+    // Float as a C++ literal that reads back exactly (pow2 atlas pages make UVs exact binary fractions)
+    std::string FloatLiteral(float v)
     {
-        if (!staticlayout) {
-        bfs += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",obj.pos.x,obj.pos.y);
-        }
-        bfs += fmt::format("\tImGui::PushItemWidth({});\n",obj.width);
-        //static double d0 = 999999.00000001;
-        //ImGui::InputDouble("input double", &d0, 0.01f, 1.0f, "%.8f");
-        bfs += fmt::format("\tstatic double d{} = 999999.00000001;\n",obj.id);
-        bfs += fmt::format("\tImGui::InputDouble(\"{}\", &d{}, 0.01f, 1.0f, \"%.8f\");\n",obj.label,obj.id);
-        bfs += "\tImGui::PopItemWidth();\n\n";
+        std::string text = fmt::format("{}", v);
+        if (text.find_first_of(".e") == std::string::npos) text += ".0";
+        return text + "f";
     }
 
-    if (obj.type == "inputscientific")
+    // Atlas types and the texture array the user fills; the table itself comes from AtlasTable()
+    std::string AtlasTypes(const ImStudio::Atlas &atlas)
     {
-        if (!staticlayout) {
-        bfs += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",obj.pos.x,obj.pos.y);
-        }
-        bfs += fmt::format("\tImGui::PushItemWidth({});\n",obj.width);
-        //static float f1 = 1.e10f;
-        //ImGui::InputFloat("input scientific", &f1, 0.0f, 0.0f, "%e");
-        bfs += fmt::format("\tstatic float f{} = 1.e10f;\n",obj.id);
-        bfs += fmt::format("\tImGui::InputFloat(\"{}\", &f{}, 0.0f, 0.0f, \"%e\");\n",obj.label,obj.id);
-        bfs += "\tImGui::PopItemWidth();\n\n";
+        std::string text;
+        text += fmt::format("// Image atlas: the window's {} image(s) packed into {} page(s) of {}x{}. Load every source into\n",
+                            atlas.images.size(), atlas.pages, atlas.pagesize, atlas.pagesize);
+        text += "// its rect (x, y, w, h) of its page and upload the pages as atlas_pages[]: images on one page share\n";
+        text += "// a texture, so ImGui draws them in one call\n";
+        text += "struct AtlasImage { const char *source; int page, x, y, w, h; ImVec2 uv0, uv1; };\n";
+        text += fmt::format("extern ImTextureID atlas_pages[{}]; // Yours: one texture per page\n", atlas.pages);
+        return text;
     }
 
-    if (obj.type == "inputfloat3")
+    std::string AtlasTable(const ImStudio::Atlas &atlas, const char *storage)
     {
-        if (!staticlayout) {
-        bfs += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",obj.pos.x,obj.pos.y);
+        std::string text = fmt::format("{}const AtlasImage atlas[] =\n{{\n", storage);
+        for (size_t n = 0; n < atlas.images.size(); n++)
+        {
+            const ImStudio::AtlasImage &i = atlas.images[n];
+            text += fmt::format("\t{{\"{}\", {}, {}, {}, {}, {}, ImVec2({}, {}), ImVec2({}, {})}}, // {}\n",
+                                Escaped(i.source.c_str()), i.page, i.x, i.y, i.w, i.h, FloatLiteral(i.uv0.x),
+                                FloatLiteral(i.uv0.y), FloatLiteral(i.uv1.x), FloatLiteral(i.uv1.y), n);
         }
-        bfs += fmt::format("\tImGui::PushItemWidth({});\n",obj.width);
-        //static float vec4a[4] = { 0.10f, 0.20f, 0.30f, 0.44f };
-        //ImGui::InputFloat3("input float3", vec4a);
-        bfs += fmt::format("\tstatic float vec4a{}[4] = {{ 0.10f, 0.20f, 0.30f, 0.44f }};\n",obj.id);
-        bfs += fmt::format("\tImGui::InputFloat3(\"{}\", vec4a{});\n",obj.label,obj.id);
-        bfs += "\tImGui::PopItemWidth();\n\n";
+        text += "};\n\n";
+        return text;
     }
+}
 
-    if (obj.type == "dragint")
+// PlotMinMax(label, values, count, size, histogram): the plot widgets of the generated code. Series longer than
+// two points per pixel column go through a copy of utils::DecimateMinMax() first, so drawing costs the same for
+// 1M points as for 2 * width. As a lambda it can be pasted into any function body; otherwise it is a header
+// function shared by the window's source files.
+std::string ImStudio::PlotHelper(bool lambda)
+{
+    static const char *body[] = {
+        "\tstatic ImVector<float> points;",
+        "\tint buckets = (int)((size.x > 0.0f) ? size.x : ImGui::CalcItemWidth());",
+        "\tint stride  = (int)sizeof(float);",
+        "\tif ((buckets > 0) && (count > buckets * 2))",
+        "\t{",
+        "\t\t// (min, max) per bucket, eight lanes so the compiler can use packed min/max",
+        "\t\tpoints.resize(buckets * 2);",
+        "\t\tfor (int b = 0; b < buckets; b++)",
+        "\t\t{",
+        "\t\t\tint begin = (int)((long long)count * b / buckets);",
+        "\t\t\tint end   = (int)((long long)count * (b + 1) / buckets);",
+        "\t\t\tfloat lo[8], hi[8];",
+        "\t\t\tfor (int k = 0; k < 8; k++) lo[k] = hi[k] = values[begin];",
+        "\t\t\tint i = begin;",
+        "\t\t\tfor (; i + 8 <= end; i += 8)",
+        "\t\t\t{",
+        "\t\t\t\tfor (int k = 0; k < 8; k++)",
+        "\t\t\t\t{",
+        "\t\t\t\t\tlo[k] = (values[i + k] < lo[k]) ? values[i + k] : lo[k];",
+        "\t\t\t\t\thi[k] = (values[i + k] > hi[k]) ? values[i + k] : hi[k];",
+        "\t\t\t\t}",
+        "\t\t\t}",
+        "\t\t\tfor (; i < end; i++)",
+        "\t\t\t{",
+        "\t\t\t\tlo[0] = (values[i] < lo[0]) ? values[i] : lo[0];",
+        "\t\t\t\thi[0] = (values[i] > hi[0]) ? values[i] : hi[0];",
+        "\t\t\t}",
+        "\t\t\tfor (int k = 1; k < 8; k++)",
+        "\t\t\t{",
+        "\t\t\t\tlo[0] = (lo[k] < lo[0]) ? lo[k] : lo[0];",
+        "\t\t\t\thi[0] = (hi[k] > hi[0]) ? hi[k] : hi[0];",
+        "\t\t\t}",
+        "\t\t\tpoints[b * 2]     = lo[0];",
+        "\t\t\tpoints[b * 2 + 1] = hi[0];",
+        "\t\t}",
+        "\t\tvalues = histogram ? &points[1] : points.Data; // a histogram shows one bar per bucket, its max",
+        "\t\tcount  = histogram ? buckets : points.Size;",
+        "\t\tstride = histogram ? (int)sizeof(float) * 2 : stride;",
+        "\t}",
+        "\tif (histogram) ImGui::PlotHistogram(label, values, count, 0, NULL, 0.0f, FLT_MAX, size, stride);",
+        "\telse           ImGui::PlotLines(label, values, count, 0, NULL, FLT_MAX, FLT_MAX, size, stride);",
+    };
+    const char *indent = lambda ? "\t" : "";
+    std::string text = fmt::format("{}// Plots: series longer than the plot is wide are reduced to (min, max) per pixel column\n", indent);
+    if (lambda) text += "\tauto PlotMinMax = [](const char *label, const float *values, int count, ImVec2 size, bool histogram)\n\t{\n";
+    else        text += "static inline void PlotMinMax(const char *label, const float *values, int count, ImVec2 size, bool histogram)\n{\n";
+    for (const char *line : body)
+        text += fmt::format("{}{}\n", indent, line);
+    text += lambda ? "\t};\n\n" : "}\n\n";
+    return text;
+}
+
+namespace
+{
+    // Helper struct of the generated code: indented and noted as a local struct when pasted into a function body
+    std::string HelperStruct(const char *const *body, size_t lines, bool local, const char *what)
     {
-        if (!staticlayout) {
-        bfs += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",obj.pos.x,obj.pos.y);
-        }
-        bfs += fmt::format("\tImGui::PushItemWidth({});\n",obj.width);
-        //static int i1 = 50;
-        //ImGui::DragInt("drag int", &i1, 1);
-        bfs += fmt::format("\tstatic int i1{0} = 50;\n",obj.id);
-        bfs += fmt::format("\tImGui::DragInt(\"{}\", &i1{}, 1);\n",obj.label,obj.id);
-        bfs += "\tImGui::PopItemWidth();\n\n";
+        std::string text;
+        if (local)
+            text += fmt::format("\t// Local to the function this is pasted into: move it to file scope to declare {} of your own with it\n", what);
+        for (size_t n = 0; n < lines; n++)
+            text += (local && *body[n]) ? fmt::format("\t{}\n", body[n]) : fmt::format("{}\n", body[n]);
+        text += "\n";
+        return text;
     }
+}
 
-    if (obj.type == "dragint100")
+// TextLog: the text log widgets of the generated code, a copy of utils::AppendLines()/ShowLines() with the text.
+// Declared inside the window block when the code is pasted into a function, at file scope otherwise.
+std::string ImStudio::LogHelper(bool local)
+{
+    static const char *body[] = {
+        "// Log text with the offset of every line start. append() only scans the bytes it adds and draw() only",
+        "// submits the lines in view, so the log can take thousands of lines per second and hold megabytes.",
+        "struct TextLog",
+        "{",
+        "\tImGuiTextBuffer text;",
+        "\tImVector<int>   lines;          // Offset of every line in text",
+        "\tbool            follow = true;  // Keep the last line in view while scrolled to the bottom",
+        "",
+        "\tvoid clear()",
+        "\t{",
+        "\t\ttext.clear();",
+        "\t\tlines.clear();",
+        "\t}",
+        "\tvoid append(const char *begin, const char *end = NULL)",
+        "\t{",
+        "\t\tint old = text.size();",
+        "\t\tif (lines.Size == 0) lines.push_back(0);",
+        "\t\ttext.append(begin, end);",
+        "\t\tfor (const char *c = text.begin() + old; (c = (const char *)memchr(c, '\\n', text.end() - c)) != NULL; c++)",
+        "\t\t\tlines.push_back((int)(c - text.begin()) + 1);",
+        "\t}",
+        "\tvoid draw(const char *id, ImVec2 size)",
+        "\t{",
+        "\t\tImGui::BeginChild(id, size, true, ImGuiWindowFlags_HorizontalScrollbar);",
+        "\t\tImGuiListClipper clipper;",
+        "\t\tclipper.Begin(lines.Size);",
+        "\t\twhile (clipper.Step())",
+        "\t\t{",
+        "\t\t\tfor (int n = clipper.DisplayStart; n < clipper.DisplayEnd; n++)",
+        "\t\t\t{",
+        "\t\t\t\tconst char *end = (n + 1 < lines.Size) ? text.begin() + lines[n + 1] - 1 : text.end();",
+        "\t\t\t\tImGui::TextUnformatted(text.begin() + lines[n], end);",
+        "\t\t\t}",
+        "\t\t}",
+        "\t\tif (follow && (ImGui::GetScrollY() >= ImGui::GetScrollMaxY())) ImGui::SetScrollHereY(1.0f);",
+        "\t\tImGui::EndChild();",
+        "\t}",
+        "};",
+    };
+    return HelperStruct(body, IM_ARRAYSIZE(body), local, "logs");
+}
+
+// LazyTree: the children a tree node is bound to, asked for through callbacks while their parent is open only.
+// Placed like TextLog.
+std::string ImStudio::TreeHelper(bool local)
+{
+    static const char *body[] = {
+        "// Tree over data of your own: count(), child() and label() are only called for nodes whose parent is open",
+        "// (node -1 is the root). The open part is kept as a flat list of rows drawn through a clipper, so a tree of",
+        "// millions of nodes costs the rows in view per frame. Call refresh() after the data changed.",
+        "struct LazyTree",
+        "{",
+        "\tint         (*count)(void *user, int node);          // Children of node",
+        "\tint         (*child)(void *user, int node, int n);   // Node of its n-th child",
+        "\tconst char *(*label)(void *user, int node);",
+        "\tvoid         *user;",
+        "\tImGuiStorage  open;                                 // node -> expanded",
+        "\tImVector<int> rows;                                 // Open part, flattened",
+        "\tImVector<int> depths;",
+        "\tbool          flat;                                 // rows are up to date",
+        "",
+        "\tvoid refresh()",
+        "\t{",
+        "\t\tflat = false;",
+        "\t}",
+        "\tvoid flatten(int node, int depth)",
+        "\t{",
+        "\t\tfor (int n = 0, c = count(user, node); n < c; n++)",
+        "\t\t{",
+        "\t\t\tint id = child(user, node, n);",
+        "\t\t\trows.push_back(id);",
+        "\t\t\tdepths.push_back(depth);",
+        "\t\t\tif (open.GetBool((ImGuiID)id)) flatten(id, depth + 1);",
+        "\t\t}",
+        "\t}",
+        "\tvoid draw()",
+        "\t{",
+        "\t\tif (!flat)",
+        "\t\t{",
+        "\t\t\trows.resize(0);",
+        "\t\t\tdepths.resize(0);",
+        "\t\t\tflatten(-1, 0);",
+        "\t\t\tflat = true;",
+        "\t\t}",
+        "\t\tfloat indent = ImGui::GetStyle().IndentSpacing;",
+        "\t\tfloat x      = ImGui::GetCursorPosX();",
+        "\t\tImGuiListClipper clipper;",
+        "\t\tclipper.Begin(rows.Size);",
+        "\t\twhile (clipper.Step())",
+        "\t\t{",
+        "\t\t\tfor (int r = clipper.DisplayStart; r < clipper.DisplayEnd; r++)",
+        "\t\t\t{",
+        "\t\t\t\tint  node = rows[r];",
+        "\t\t\t\tbool was  = open.GetBool((ImGuiID)node);",
+        "\t\t\t\tImGui::SetCursorPosX(x + depths[r] * indent);",
+        "\t\t\t\tImGui::SetNextItemOpen(was);",
+        "\t\t\t\tImGui::PushID(node);",
+        "\t\t\t\tbool now = ImGui::TreeNodeEx(\"\", ImGuiTreeNodeFlags_NoTreePushOnOpen | (count(user, node) ? 0 : ImGuiTreeNodeFlags_Leaf),",
+        "\t\t\t\t                             \"%s\", label(user, node));",
+        "\t\t\t\tImGui::PopID();",
+        "\t\t\t\tif (now == was) continue;",
+        "\t\t\t\topen.SetBool((ImGuiID)node, now);",
+        "\t\t\t\tflat = false;",
+        "\t\t\t}",
+        "\t\t}",
+        "\t}",
+        "};",
+    };
+    return HelperStruct(body, IM_ARRAYSIZE(body), local, "trees");
+}
+
+namespace
+{
+    // The text log a widget draws: the bound source (a TextLog of the user's), or one of its own state
+    std::string LogSource(const ImStudio::BaseObject &obj, ImStudio::GeneratorContext* ctx, std::string* decl)
     {
-        if (!staticlayout) {
-        bfs += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",obj.pos.x,obj.pos.y);
-        }
-        bfs += fmt::format("\tImGui::PushItemWidth({});\n",obj.width);
-        //static int i2 = 42;
-        //ImGui::DragInt("drag int 0..100", &i2, 1, 0, 100, "%d%%", ImGuiSliderFlags_AlwaysClamp);
-        bfs += fmt::format("\tstatic int i2{0} = 42;\n",obj.id);
-        bfs += fmt::format("\tImGui::DragInt(\"{}\", &i2{}, 1, 0, 100, \"%d%%\", ImGuiSliderFlags_AlwaysClamp);\n",obj.label,obj.id);
-        bfs += "\tImGui::PopItemWidth();\n\n";
+        ctx->logs = true;
+        if (!obj.value_s.empty())
+            return fmt::format("({})", obj.value_s);
+        *decl = ImStudio::StateDecl(ctx, fmt::format("TextLog log{} = {{}}", obj.id));
+        return fmt::format("log{}", obj.id);
     }
 
-    if (obj.type == "dragfloat")
+    // Pointer and count of a plot's data: the bound source (any float container with data() and size()), or
+    // a vector of the widget's own state when none is bound
+    std::string PlotSeries(const ImStudio::BaseObject &obj, ImStudio::GeneratorContext* ctx, std::string* decl)
     {
-        if (!staticlayout) {
-        bfs += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",obj.pos.x,obj.pos.y);
-        }
-        bfs += fmt::format("\tImGui::PushItemWidth({});\n",obj.width);
-        //static float f1 = 1.00f;
-        //ImGui::DragFloat("drag float", &f1, 0.005f);
-        bfs += fmt::format("\tstatic float f1{0} = 1.00f;\n",obj.id);
-        bfs += fmt::format("\tImGui::DragFloat(\"{}\", &f1{}, 0.005f);\n",obj.label,obj.id);
-        bfs += "\tImGui::PopItemWidth();\n\n";
+        ctx->plots = true;
+        if (!obj.value_s.empty())
+            return fmt::format("({0}).data(), (int)({0}).size()", obj.value_s);
+        *decl = ImStudio::StateDecl(ctx, fmt::format("ImVector<float> values{} = {{}}", obj.id));
+        return fmt::format("values{0}.Data, values{0}.Size", obj.id);
     }
 
-    if (obj.type == "dragfloatsmall")
+    enum IdSource
+    {
+        ID_NONE,                                                                   // Widget pushes no ID
+        ID_LABEL,
+        ID_VALUE,                                                                  // Button caption
+        ID_LEFT,                                                                   //--
+        ID_RIGHT                                                                   //  | Arrow pair
+    };
+
+    // What the generated code hashes into the widget's ID(s)
+    int IdSources(const ImStudio::BaseObject &obj, int sources[2])
     {
-        if (!staticlayout) {
-        bfs += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",obj.pos.x,obj.pos.y);
+        sources[0] = ID_NONE;
+        if (obj.type == "button")
+        {
+            sources[0] = ID_VALUE;
+            return 1;
         }
-        bfs += fmt::format("\tImGui::PushItemWidth({});\n",obj.width);
-        //static float f2 = 0.0067f;
-        //ImGui::DragFloat("drag small float", &f2, 0.0001f, 0.0f, 0.0f, "%.06f ns");
-        bfs += fmt::format("\tstatic float f2{0} = 0.0067f;\n",obj.id);
-        bfs += fmt::format("\tImGui::DragFloat(\"{}\", &f2{}, 0.0001f, 0.0f, 0.0f, \"%.06f ns\");\n",obj.label,obj.id);
-        bfs += "\tImGui::PopItemWidth();\n\n";
+        if (obj.type == "arrow")
+        {
+            sources[0] = ID_LEFT;
+            sources[1] = ID_RIGHT;
+            return 2;
+        }
+        if (ImStudio::TrailingLabel(obj.type) || (obj.type == "textlog") || (obj.type == "treenode")) sources[0] = ID_LABEL;
+        return 1;
     }
 
-    if (obj.type == "sliderint")
+    const std::string &IdLabel(const ImStudio::BaseObject &obj, int source)
     {
-        if (!staticlayout) {
-        bfs += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",obj.pos.x,obj.pos.y);
+        static const std::string none  = "";
+        static const std::string left  = "##left";
+        static const std::string right = "##right";
+        switch (source)
+        {
+        case ID_LABEL: return obj.label;
+        case ID_VALUE: return obj.value_s;
+        case ID_LEFT:  return left;
+        case ID_RIGHT: return right;
         }
-        bfs += fmt::format("\tImGui::PushItemWidth({});\n",obj.width);
-        //static int i1 = 0;
-        //ImGui::SliderInt("slider int", &i1, -1, 3);
-        bfs += fmt::format("\tstatic int i1{0} = 0;\n",obj.id);
-        bfs += fmt::format("\tImGui::SliderInt(\"{}\", &i1{}, -1, 3);\n",obj.label,obj.id);
-        bfs += "\tImGui::PopItemWidth();\n\n";
+        return none;
     }
 
-    if (obj.type == "sliderfloat")
+    // Moves one widget in or out of the per-ID counts; touching an ID shared before or after asks for regrouping
+    void Count(ImStudio::IdCheck* check, ImGuiID id, int delta)
+    {
+        int &n = check->counts[id];
+        bool wasshared = (n >= 2);
+        n += delta;
+        if (wasshared || (n >= 2)) check->regroup = true;
+        check->shared += (int)(n >= 2) - (int)wasshared;
+        if (n == 0) check->counts.erase(id);
+    }
+
+    void Truncate(ImStudio::IdCheck* check, size_t size)
     {
-        if (!staticlayout) {
-        bfs += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",obj.pos.x,obj.pos.y);
+        for (size_t i = size; i < check->entries.size(); i++)
+        {
+            if (check->entries[i].source != ID_NONE) Count(check, check->entries[i].id, -1);
         }
-        bfs += fmt::format("\tImGui::PushItemWidth({});\n",obj.width);
-        //static float f1 = 0.123f;
-        //ImGui::SliderFloat("slider float", &f1, 0.0f, 1.0f, "ratio = %.3f");
-        bfs += fmt::format("\tstatic float f1{0} = 0.123f;\n",obj.id);
-        bfs += fmt::format("\tImGui::SliderFloat(\"{}\", &f1{}, 0.0f, 1.0f, \"ratio = %.3f\");\n",obj.label,obj.id);
-        bfs += "\tImGui::PopItemWidth();\n\n";
+        check->entries.resize(size);
     }
 
-    if (obj.type == "sliderfloatlog")
+    // Brings the entries of one widget up to date. A widget that is not where the last update left it (added,
+    // deleted) drops every entry from there on, so the rest of the design is hashed again this once.
+    void CheckWidget(ImStudio::IdCheck* check, size_t* at, const ImStudio::BaseObject &obj, ImGuiID seed)
     {
-        if (!staticlayout) {
-        bfs += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",obj.pos.x,obj.pos.y);
+        std::vector<ImStudio::IdEntry> &entries = check->entries;
+        if ((*at < entries.size()) && (entries[*at].object != obj.id))
+            Truncate(check, *at);
+
+        bool fresh = (*at == entries.size());
+        if (fresh)
+        {
+            int sources[2];
+            int count = IdSources(obj, sources);
+            for (int n = 0; n < count; n++)
+            {
+                ImStudio::IdEntry e;
+                e.object     = obj.id;
+                e.identifier = obj.identifier;
+                e.source     = sources[n];
+                entries.push_back(e);
+            }
+        }
+
+        for (; (*at < entries.size()) && (entries[*at].object == obj.id); (*at)++)
+        {
+            ImStudio::IdEntry &e = entries[*at];
+            if (e.source == ID_NONE) continue;
+            const std::string &label = IdLabel(obj, e.source);
+            if (!fresh && (e.seed == seed) && (e.label == label)) continue;
+            if (!fresh) Count(check, e.id, -1);
+            e.label = label;
+            e.seed  = seed;
+            e.id    = ImHashStr(label.c_str(), 0, seed);
+            Count(check, e.id, 1);
+            check->rehashed++;
         }
-        bfs += fmt::format("\tImGui::PushItemWidth({});\n",obj.width);
-        //static float f2 = 0.0f;
-        //ImGui::SliderFloat("slider float (log)", &f2, -10.0f, 10.0f, "%.4f", ImGuiSliderFlags_Logarithmic);
-        bfs += fmt::format("\tstatic float f2{0} = 0.0f;\n",obj.id);
-        bfs += fmt::format("\tImGui::SliderFloat(\"{}\", &f2{}, -10.0f, 10.0f, \"%.4f\", ImGuiSliderFlags_Logarithmic);\n",obj.label,obj.id);
-        bfs += "\tImGui::PopItemWidth();\n\n";
     }
+}
 
-    if (obj.type == "sliderangle")
+bool ImStudio::IdCheck::update(const BufferWindow &bw)
+{
+    rehashed = 0;
+    size_t at   = 0;
+    ImGuiID seed = WindowSeed(0);
+    for (const Object &o : bw.objects)
     {
-        if (!staticlayout) {
-        bfs += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",obj.pos.x,obj.pos.y);
+        if (!IsContainer(o.type))
+        {
+            CheckWidget(this, &at, o, seed);
+            continue;
         }
-        bfs += fmt::format("\tImGui::PushItemWidth({});\n",obj.width);
-        //static float angle = 0.0f;
-        //ImGui::SliderAngle("slider angle", &angle);
-        bfs += fmt::format("\tstatic float angle{0} = 0.0f;\n",obj.id);
-        bfs += fmt::format("\tImGui::SliderAngle(\"{}\", &angle{});\n",obj.label,obj.id);
-        bfs += "\tImGui::PopItemWidth();\n\n";
+        if (o.type == "treenode") CheckWidget(this, &at, o, seed);
+        ImGuiID childseed = (o.type == "child") ? WindowSeed(o.child.id) : ImHashStr(o.label.c_str(), 0, seed); // TreePush()
+        for (const BaseObject &cw : o.child.objects)
+            CheckWidget(this, &at, cw, childseed);
     }
+    Truncate(this, at);
+    if (!regroup) return false;
+    regroup = false;
 
-    if (obj.type == "color1")
+    // one pass over the widgets with a shared ID, skipped entirely when there are none
+    collisions.clear();
+    if (shared == 0) return true;
+    std::unordered_map<ImGuiID, size_t> group;
+    for (size_t i = 0; i < entries.size(); i++)
     {
-        if (!staticlayout) {
-        bfs += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",obj.pos.x,obj.pos.y);
+        const IdEntry &e = entries[i];
+        if ((e.source == ID_NONE) || (counts[e.id] < 2)) continue;
+
+        auto found = group.find(e.id);
+        if (found == group.end())
+        {
+            IdCollision c;
+            c.id    = e.id;
+            c.label = e.label;
+            found   = group.emplace(e.id, collisions.size()).first;
+            collisions.push_back(c);
         }
-        //static float col1[3] = {1.0f, 0.0f, 0.2f};
-        //ImGui::ColorEdit3(label.c_str(), col1, ImGuiColorEditFlags_NoInputs);
-        bfs += fmt::format("\tstatic float col1{0}[3] = {{1.0f, 0.0f, 0.2f}};\n",obj.id);
-        bfs += fmt::format("\tImGui::ColorEdit3(\"{}\", col1{}, ImGuiColorEditFlags_NoInputs);\n\n",obj.label,obj.id);
+        collisions[found->second].entries.push_back(i);
     }
+    return true;
+}
 
-    if (obj.type == "color2")
+void ImStudio::CodeList::text(const std::string &text, int kind)
+{
+    if (text.empty()) return;
+    CodeOp op;
+    op.kind = kind;
+    op.text = text;
+    ops.push_back(op);
+}
+
+void ImStudio::CodeList::decl(const std::string &text)
+{
+    this->text(text, CODE_DECL);
+}
+
+void ImStudio::CodeList::cursor(ImVec2 pos)
+{
+    CodeOp op;
+    op.kind = CODE_CURSOR;
+    op.pos  = pos;
+    ops.push_back(op);
+}
+
+void ImStudio::CodeList::pushwidth(float width, const char *note)
+{
+    CodeOp op;
+    op.kind  = CODE_PUSHWIDTH;
+    op.text  = note;
+    op.pos.x = width;
+    ops.push_back(op);
+}
+
+void ImStudio::CodeList::popwidth()
+{
+    CodeOp op;
+    op.kind = CODE_POPWIDTH;
+    for (size_t i = ops.size(); i-- > 0;)// width of the scope being closed, for MergeWidthScopes()
+    {
+        if (ops[i].kind != CODE_PUSHWIDTH) continue;
+        op.pos.x = ops[i].pos.x;
+        break;
+    }
+    ops.push_back(op);
+    blank();
+}
+
+void ImStudio::CodeList::items(const std::string &name, const std::string &init, bool once)
+{
+    CodeOp op;
+    op.kind = CODE_ITEMS;
+    op.name = name;
+    op.init = init;
+    op.once = once;
+    ops.push_back(op);
+}
+
+void ImStudio::CodeList::itemscall(const std::string &text, const std::string &name)
+{
+    CodeOp op;
+    op.kind = CODE_ITEMSCALL;
+    op.text = text;
+    op.name = name;
+    ops.push_back(op);
+}
+
+void ImStudio::CodeList::sameline()
+{
+    CodeOp op;
+    op.kind = CODE_SAMELINE;
+    ops.push_back(op);
+    blank();
+}
+
+void ImStudio::CodeList::blank()
+{
+    CodeOp op;
+    op.kind = CODE_BLANK;
+    ops.push_back(op);
+}
+
+int ImStudio::CodeList::calls() const
+{
+    int count = 0;
+    for (const CodeOp &op : ops)
     {
-        if (!staticlayout) {
-        bfs += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",obj.pos.x,obj.pos.y);
+        switch (op.kind)
+        {
+        case CODE_CURSOR:
+        case CODE_PUSHWIDTH:
+        case CODE_POPWIDTH:
+        case CODE_SAMELINE:
+            count++;
+            break;
+        case CODE_TEXT:
+        case CODE_ITEMSCALL:
+        case CODE_BEGINSCOPE:
+        case CODE_ENDSCOPE:
+            for (size_t at = op.text.find("ImGui::"); at != std::string::npos; at = op.text.find("ImGui::", at + 7))
+                count++;
+            break;
         }
-        bfs += fmt::format("\tImGui::PushItemWidth({});\n",obj.width);
-        //static float col2[3] = {1.0f, 0.0f, 0.2f};
-        //ImGui::ColorEdit3(label.c_str(), col2);
-        bfs += fmt::format("\tstatic float col2{0}[3] = {{1.0f, 0.0f, 0.2f}};\n",obj.id);
-        bfs += fmt::format("\tImGui::ColorEdit3(\"{}\", col2{});\n\n",obj.label,obj.id);
-        bfs += "\tImGui::PopItemWidth();\n\n";
     }
+    return count;
+}
 
-    if (obj.type == "color3")
+namespace
+{
+    using ImStudio::CodeOp;
+
+    // Index of the first op from i on that is not one of the skipped kinds
+    size_t SkipOps(const std::vector<CodeOp> &ops, size_t i, std::initializer_list<int> skipped)
     {
-        if (!staticlayout) {
-        bfs += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",obj.pos.x,obj.pos.y);
+        for (; i < ops.size(); i++)
+        {
+            bool skip = false;
+            for (int kind : skipped) skip |= (ops[i].kind == kind);
+            if (!skip) break;
         }
-        bfs += fmt::format("\tImGui::PushItemWidth({});\n",obj.width);
-        //static float col3[4] = {0.4f, 0.7f, 0.0f, 0.5f};
-        //ImGui::ColorEdit4(label.c_str(), col3);
-        bfs += fmt::format("\tstatic float col3{0}[4] = {{0.4f, 0.7f, 0.0f, 0.5f}};\n",obj.id);
-        bfs += fmt::format("\tImGui::ColorEdit4(\"{}\", col3{});\n\n",obj.label,obj.id);
-        bfs += "\tImGui::PopItemWidth();\n\n";
+        return i;
     }
 
-    if (obj.type == "sameline")
+    // PopItemWidth(w) ... PushItemWidth(w) with no item in between: keep the first scope open
+    bool MergeWidthScopes(std::vector<CodeOp> &ops)
     {
-        if (staticlayout) {
-        bfs += "\tImGui::SameLine();\n\n";
+        bool changed = false;
+        for (size_t i = 0; i < ops.size(); i++)
+        {
+            if (ops[i].kind != ImStudio::CODE_POPWIDTH) continue;
+            size_t j = SkipOps(ops, i + 1, {ImStudio::CODE_BLANK, ImStudio::CODE_DECL, ImStudio::CODE_ITEMS, ImStudio::CODE_CURSOR});
+            if ((j < ops.size()) && (ops[j].kind == ImStudio::CODE_PUSHWIDTH) && (ops[j].pos.x == ops[i].pos.x))
+            {
+                ops[i].kind = ImStudio::CODE_NONE;
+                ops[j].kind = ImStudio::CODE_NONE;
+                changed     = true;
+            }
         }
+        return changed;
     }
 
-    if (obj.type == "newline")
+    // SetCursorPos followed by another one with no item in between. Only dropped when it does not reach past the
+    // second one, since SetCursorPos also grows the window content size.
+    // SameLine followed by another SameLine or by the end of the window/child. The end of the list is only the end
+    // of the window for its last part; an earlier split part goes on into the next one.
+    bool DropCursorMoves(std::vector<CodeOp> &ops, bool last)
     {
-        if (staticlayout) {
-        bfs += "\tImGui::NewLine();\n\n";
+        bool changed = false;
+        for (size_t i = 0; i < ops.size(); i++)
+        {
+            if (ops[i].kind == ImStudio::CODE_CURSOR)
+            {
+                size_t j = SkipOps(ops, i + 1, {ImStudio::CODE_BLANK, ImStudio::CODE_DECL, ImStudio::CODE_ITEMS,
+                                                ImStudio::CODE_PUSHWIDTH, ImStudio::CODE_POPWIDTH});
+                if ((j < ops.size()) && (ops[j].kind == ImStudio::CODE_CURSOR) &&
+                    (ops[i].pos.x <= ops[j].pos.x) && (ops[i].pos.y <= ops[j].pos.y))
+                {
+                    ops[i].kind = ImStudio::CODE_NONE;
+                    changed     = true;
+                }
+            }
+            if (ops[i].kind == ImStudio::CODE_SAMELINE)
+            {
+                size_t j = SkipOps(ops, i + 1, {ImStudio::CODE_BLANK, ImStudio::CODE_DECL, ImStudio::CODE_ITEMS,
+                                                ImStudio::CODE_PUSHWIDTH, ImStudio::CODE_POPWIDTH});
+                if (((j == ops.size()) && last) ||
+                    ((j < ops.size()) && ((ops[j].kind == ImStudio::CODE_SAMELINE) || (ops[j].kind == ImStudio::CODE_ENDSCOPE))))
+                {
+                    ops[i].kind = ImStudio::CODE_NONE;
+                    changed     = true;
+                }
+            }
         }
+        return changed;
     }
 
-    if (obj.type == "separator")
+    // Identical items arrays used by several widgets become one static array at the top of the body
+    bool HoistItems(std::vector<CodeOp> &ops)
     {
-        if (staticlayout) {
-        bfs += "\tImGui::Separator();\n\n";
+        std::map<std::string, std::vector<size_t>> uses;
+        int hoisted = 0;
+        for (size_t i = 0; i < ops.size(); i++)
+        {
+            if (ops[i].kind != ImStudio::CODE_ITEMS) continue;
+            if (ops[i].hoisted) hoisted++;
+            else                uses[ops[i].init].push_back(i);
+        }
+
+        std::map<std::string, std::string> renamed;
+        std::vector<CodeOp> top;
+        for (auto &use : uses)
+        {
+            if (use.second.size() < 2) continue;
+            CodeOp op;
+            op.kind    = ImStudio::CODE_ITEMS;
+            op.name    = hoisted ? fmt::format("items_{}", hoisted) : std::string("items");
+            op.init    = use.first;
+            op.hoisted = true;
+            hoisted++;
+            for (size_t i : use.second)
+            {
+                renamed[ops[i].name] = op.name;
+                ops[i].kind = ImStudio::CODE_NONE;
+            }
+            top.push_back(op);
+        }
+        if (top.empty()) return false;
+
+        for (CodeOp &op : ops)
+        {
+            auto found = (op.kind == ImStudio::CODE_ITEMSCALL) ? renamed.find(op.name) : renamed.end();
+            if (found != renamed.end()) op.name = found->second;
         }
+        CodeOp blank;
+        blank.kind = ImStudio::CODE_BLANK;
+        top.push_back(blank);
+        ops.insert(ops.begin(), top.begin(), top.end());
+        return true;
     }
 
-    if (obj.type == "progressbar")
+    // Drops removed ops, and blank lines left doubled by the removals
+    void CompactOps(std::vector<CodeOp> &ops)
     {
-        if (!staticlayout) {
-        bfs += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",obj.pos.x,obj.pos.y);
+        size_t out = 0;
+        for (size_t i = 0; i < ops.size(); i++)
+        {
+            if (ops[i].kind == ImStudio::CODE_NONE) continue;
+            if ((ops[i].kind == ImStudio::CODE_BLANK) && (out > 0) && (ops[out - 1].kind == ImStudio::CODE_BLANK)) continue;
+            if (out != i) ops[out] = std::move(ops[i]);
+            out++;
         }
-        bfs += fmt::format("\tImGui::PushItemWidth({});\n",obj.width);
-        //static float progress = 0.0f;
-        //ImGui::ProgressBar(progress, ImVec2(0.0f, 0.0f));
-        bfs += fmt::format("\tstatic float progress{} = 0.0f;\n",obj.id);
-        bfs += fmt::format("\tImGui::ProgressBar(progress{}, ImVec2(0.0f, 0.0f));\n",obj.id);
-        bfs += "\tImGui::PopItemWidth();\n\n";
+        ops.resize(out);
     }
-    
-    output->append(bfs);
-    
 }
 
-void ImStudio::GenerateCode(std::string* output, BufferWindow* bw)
+void ImStudio::CodeList::optimize(CodeStats* stats, bool last)
 {
-#ifdef __EMSCRIPTEN__
-    *output  = "/*\nGENERATED CODE | READ-ONLY\nCopy by clicking the above button\n*/\n\n";
-#else
-    *output  = "/*\nGENERATED CODE | READ-ONLY\nYou can directly copy from here, or from File > Export to clipboard\n*/\n\n";
-#endif
-    *output += "static bool window = true;\n";
-    *output += fmt::format("ImGui::SetNextWindowSize(ImVec2({},{}));\n", bw->size.x, bw->size.y);
-    *output += "//!! You might want to use these ^^ values in the OS window instead, and add the ImGuiWindowFlags_NoTitleBar flag in the ImGui window !!\n\n";
-    *output += "if (ImGui::Begin(\"window_name\", &window))\n{\n\n";
-    for (auto i = bw->objects.begin(); i != bw->objects.end(); ++i)
+    stats->before += calls();
+    bool changed = true;
+    while (changed)
     {
-        Object &o = *i;
+        changed  = MergeWidthScopes(ops);
+        changed |= DropCursorMoves(ops, last);
+        changed |= HoistItems(ops);
+        CompactOps(ops);
+        stats->passes += 3;
+    }
+    stats->after += calls();
+}
 
-        if (o.type != "child")
+void ImStudio::CodeList::emit(std::string* output) const
+{
+    auto out = std::back_inserter(*output);
+    for (const CodeOp &op : ops)
+    {
+        switch (op.kind)
         {
-            Recreate(o, output, bw->staticlayout);
+        case CODE_TEXT:
+        case CODE_DECL:
+        case CODE_REGION:
+        case CODE_BEGINSCOPE:
+        case CODE_ENDSCOPE:
+            *output += op.text;
+            break;
+        case CODE_CURSOR:
+            fmt::format_to(out, "\tImGui::SetCursorPos(ImVec2({},{}));\n", op.pos.x, op.pos.y);
+            break;
+        case CODE_PUSHWIDTH:
+            fmt::format_to(out, "\tImGui::PushItemWidth({});{}\n", op.pos.x, op.text);
+            break;
+        case CODE_POPWIDTH:
+            *output += "\tImGui::PopItemWidth();\n";
+            break;
+        case CODE_ITEMS:
+            fmt::format_to(out, "\t{}const char *{}[] = {};\n", (op.hoisted || op.once) ? "static " : "", op.name, op.init);
+            break;
+        case CODE_ITEMSCALL:
+            for (char c : op.text)
+            {
+                if (c == '\x01') *output += op.name;
+                else              *output += c;
+            }
+            break;
+        case CODE_SAMELINE:
+            *output += "\tImGui::SameLine();\n";
+            break;
+        case CODE_BLANK:
+            *output += "\n";
+            break;
         }
-        else
+    }
+}
+
+void ImStudio::Recreate(const BaseObject &obj, CodeList* code, GeneratorContext* ctx)
+{
+    if (ctx->opts->templates)
+    {
+        int section = ctx->opts->templates->find(obj.type);
+        if (section >= 0)
         {
-            if (!bw->staticlayout) {
-            *output += fmt::format("\tImGui::SetCursorPos(ImVec2({},{}));\n",o.child.freerect.Min.x,o.child.freerect.Min.y);
-            }
-            *output += fmt::format("\tImGui::BeginChild({}, ImVec2({},{}), {});\n\n", o.child.id, o.child.freerect.GetSize().x, o.child.freerect.GetSize().y, o.child.border);
-            for (auto i = o.child.objects.begin(); i != o.child.objects.end(); ++i)
-            {
-                BaseObject &cw = *i;// child widget
+            TemplateArgs args;
+            args.obj          = &obj;
+            args.window       = windowname;
+            args.staticlayout = ctx->staticlayout;
+            std::string text;
+            ctx->opts->templates->emit(section, args, &text);
+            code->text(text);
+            return;
+        }
+    }
+
+    // With precomputed IDs, hidden labels ("##...") are hashed here and pushed as-is; the widget then gets an
+    // empty label, which resolves to the same ID without any per-frame hashing. Visible labels are left to
+    // ImGui: splitting them into a separate text item costs more per frame than the hash it saves.
+    std::string label = Literal(ctx, obj.label);
+    std::string idscope;
+    std::string idtail;
+    if ((ctx->opts->hashedids) && (VisibleLabel(obj.label).empty()))
+    {
+        label   = "\"\"";
+        idscope = fmt::format("\tImGui::PushOverrideID(0x{:08X}u); // \"{}\"\n", ImHashStr(obj.label.c_str(), 0, ctx->seed), obj.label);
+        idtail  = "\tImGui::PopID();\n";
+    }
 
-                Recreate(cw, output, bw->staticlayout);
+    if (obj.type == "button")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        code->text(fmt::format("\tImGui::Button({}, ImVec2({},{})); //remove size argument (ImVec2) to auto-resize\n\n",Literal(ctx, obj.value_s), obj.size.x, obj.size.y));
+        
+    }
 
-            }
-            *output += "\tImGui::EndChild();\n\n";
+    if (obj.type == "radio")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        std::string var = StateVar(ctx, obj, code, fmt::format("bool r1{} = false",obj.id));
+        code->text(idscope);
+        code->text(fmt::format("\tImGui::RadioButton({}, {});\n",label, var));
+        code->text(idtail);
+        code->blank();
+    }
+
+    if (obj.type == "checkbox")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        std::string var = StateVar(ctx, obj, code, fmt::format("bool c1{} = false",obj.id));
+        code->text(idscope);
+        code->text(fmt::format("\tImGui::Checkbox({}, &{});\n",label, var));
+        code->text(idtail);
+        code->blank();
+    }
+
+    if (obj.type == "text")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
         }
+        code->text(fmt::format("\tImGui::Text(\"{}\");\n\n",obj.value_s));
     }
-    *output += "\n\tImGui::End();\n}\n";
-    *output += "\n/*\nReminder: some widgets may have the same label \"##\" (if you didn't change it), and can lead to undesired ID collisions.\nMore info: https://github.com/ocornut/imgui/blob/master/docs/FAQ.md#q-about-the-id-stack-system\n*/\n";
-    ImGui::InputTextMultiline("##source", output,
-                              ImVec2(-FLT_MIN, ImGui::GetTextLineHeight() * 64), ImGuiInputTextFlags_ReadOnly);
 
-}
\ No newline at end of file
+    if (obj.type == "bullet")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        code->text("\tImGui::Bullet();\n\n");
+        
+    }
+
+    if (obj.type == "arrow")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        if (ctx->opts->hashedids)
+        {
+            code->text(fmt::format("\tImGui::PushOverrideID(0x{:08X}u); // \"##left\"\n", ImHashStr("##left", 0, ctx->seed)));
+            code->text("\tImGui::ArrowButton(\"\", ImGuiDir_Left);\n");
+            code->text("\tImGui::PopID();\n");
+            code->text("\tImGui::SameLine();\n");
+            code->text(fmt::format("\tImGui::PushOverrideID(0x{:08X}u); // \"##right\"\n", ImHashStr("##right", 0, ctx->seed)));
+            code->text("\tImGui::ArrowButton(\"\", ImGuiDir_Right);\n");
+            code->text("\tImGui::PopID();\n\n");
+        }
+        else
+        {
+            code->text("\tImGui::ArrowButton(\"##left\", ImGuiDir_Left);\n");
+            code->text("\tImGui::SameLine();\n");
+            code->text("\tImGui::ArrowButton(\"##right\", ImGuiDir_Right);\n\n");
+        }
+    }
+
+    if ((obj.type == "combo") || (obj.type == "listbox"))
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        code->pushwidth(obj.width);
+        std::string cur = StateVar(ctx, obj, code, fmt::format("int item_current{} = 0",obj.id));
+        const ItemList &list = obj.itemlist;
+        bool clipped = (obj.type == "combo") && (list.count() > cliplist);
+        if (list.count() == 0)
+        {
+            code->text(idscope);
+            code->text(ItemsCall(obj, label, cur, "NULL", -1, "0", false));
+        }
+        else if (ctx->opts->stringtable)
+        {
+            code->text(idscope);
+            code->text(ItemsCall(obj, label, cur, "strings", ctx->strings.addlist(ItemStrings(list)), std::to_string(list.count()), clipped));
+        }
+        else
+        {
+            std::string name = fmt::format("items{}", obj.id);
+            code->items(name, ItemsInit(list), list.count() > cliplist); // not rebuilt on the stack every frame
+            code->text(idscope);
+            code->itemscall(ItemsCall(obj, label, cur, "\x01", -1, "IM_ARRAYSIZE(\x01)", clipped), name);
+        }
+        code->text(idtail);
+        code->popwidth();
+    }
+
+    if (obj.type == "textinput")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        code->pushwidth(obj.width, " //NOTE: (Push/Pop)ItemWidth is optional");
+        //static char str0[128] = "Hello, world!";
+        //ImGui::InputText("input text", str0, IM_ARRAYSIZE(str0));
+        std::string var = StateVar(ctx, obj, code, fmt::format("char str{}[128] = \"{}\"",obj.id,obj.value_s));
+        code->text(idscope);
+        code->text(fmt::format("\tImGui::InputText({0}, {1}, IM_ARRAYSIZE({1}));\n",label,var));
+        code->text(idtail);
+        code->popwidth();
+    }
+
+    if (obj.type == "inputint")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        code->pushwidth(obj.width);
+        //static int i0 = 123;
+        //ImGui::InputInt("input int", &i0);
+        std::string var = StateVar(ctx, obj, code, fmt::format("int i{} = 123",obj.id));
+        code->text(idscope);
+        code->text(fmt::format("\tImGui::InputInt({}, &{});\n",label,var));
+        code->text(idtail);
+        code->popwidth();
+    }
+
+    if (obj.type == "inputfloat")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        code->pushwidth(obj.width);
+        //static float f0 = 0.001f;
+        //ImGui::InputFloat("input float", &f0, 0.01f, 1.0f, "%.3f");
+        std::string var = StateVar(ctx, obj, code, fmt::format("float f{} = 0.001f",obj.id));
+        code->text(idscope);
+        code->text(fmt::format("\tImGui::InputFloat({}, &{}, 0.01f, 1.0f, \"%.3f\");\n",label,var));
+        code->text(idtail);
+        code->popwidth();
+    }
+
+    if (obj.type == "inputdouble")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        code->pushwidth(obj.width);
+        //static double d0 = 999999.00000001;
+        //ImGui::InputDouble("input double", &d0, 0.01f, 1.0f, "%.8f");
+        std::string var = StateVar(ctx, obj, code, fmt::format("double d{} = 999999.00000001",obj.id));
+        code->text(idscope);
+        code->text(fmt::format("\tImGui::InputDouble({}, &{}, 0.01f, 1.0f, \"%.8f\");\n",label,var));
+        code->text(idtail);
+        code->popwidth();
+    }
+
+    if (obj.type == "inputscientific")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        code->pushwidth(obj.width);
+        //static float f1 = 1.e10f;
+        //ImGui::InputFloat("input scientific", &f1, 0.0f, 0.0f, "%e");
+        std::string var = StateVar(ctx, obj, code, fmt::format("float f{} = 1.e10f",obj.id));
+        code->text(idscope);
+        code->text(fmt::format("\tImGui::InputFloat({}, &{}, 0.0f, 0.0f, \"%e\");\n",label,var));
+        code->text(idtail);
+        code->popwidth();
+    }
+
+    if (obj.type == "inputfloat3")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        code->pushwidth(obj.width);
+        //static float vec4a[4] = { 0.10f, 0.20f, 0.30f, 0.44f };
+        //ImGui::InputFloat3("input float3", vec4a);
+        std::string var = StateVar(ctx, obj, code, fmt::format("float vec4a{}[4] = {{ 0.10f, 0.20f, 0.30f, 0.44f }}",obj.id));
+        code->text(idscope);
+        code->text(fmt::format("\tImGui::InputFloat3({}, {});\n",label,var));
+        code->text(idtail);
+        code->popwidth();
+    }
+
+    if (obj.type == "dragint")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        code->pushwidth(obj.width);
+        //static int i1 = 50;
+        //ImGui::DragInt("drag int", &i1, 1);
+        std::string var = StateVar(ctx, obj, code, fmt::format("int i1{0} = 50",obj.id));
+        code->text(idscope);
+        code->text(fmt::format("\tImGui::DragInt({}, &{}, 1);\n",label,var));
+        code->text(idtail);
+        code->popwidth();
+    }
+
+    if (obj.type == "dragint100")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        code->pushwidth(obj.width);
+        //static int i2 = 42;
+        //ImGui::DragInt("drag int 0..100", &i2, 1, 0, 100, "%d%%", ImGuiSliderFlags_AlwaysClamp);
+        std::string var = StateVar(ctx, obj, code, fmt::format("int i2{0} = 42",obj.id));
+        code->text(idscope);
+        code->text(fmt::format("\tImGui::DragInt({}, &{}, 1, 0, 100, \"%d%%\", ImGuiSliderFlags_AlwaysClamp);\n",label,var));
+        code->text(idtail);
+        code->popwidth();
+    }
+
+    if (obj.type == "dragfloat")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        code->pushwidth(obj.width);
+        //static float f1 = 1.00f;
+        //ImGui::DragFloat("drag float", &f1, 0.005f);
+        std::string var = StateVar(ctx, obj, code, fmt::format("float f1{0} = 1.00f",obj.id));
+        code->text(idscope);
+        code->text(fmt::format("\tImGui::DragFloat({}, &{}, 0.005f);\n",label,var));
+        code->text(idtail);
+        code->popwidth();
+    }
+
+    if (obj.type == "dragfloatsmall")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        code->pushwidth(obj.width);
+        //static float f2 = 0.0067f;
+        //ImGui::DragFloat("drag small float", &f2, 0.0001f, 0.0f, 0.0f, "%.06f ns");
+        std::string var = StateVar(ctx, obj, code, fmt::format("float f2{0} = 0.0067f",obj.id));
+        code->text(idscope);
+        code->text(fmt::format("\tImGui::DragFloat({}, &{}, 0.0001f, 0.0f, 0.0f, \"%.06f ns\");\n",label,var));
+        code->text(idtail);
+        code->popwidth();
+    }
+
+    if (obj.type == "sliderint")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        code->pushwidth(obj.width);
+        //static int i1 = 0;
+        //ImGui::SliderInt("slider int", &i1, -1, 3);
+        std::string var = StateVar(ctx, obj, code, fmt::format("int i1{0} = 0",obj.id));
+        code->text(idscope);
+        code->text(fmt::format("\tImGui::SliderInt({}, &{}, -1, 3);\n",label,var));
+        code->text(idtail);
+        code->popwidth();
+    }
+
+    if (obj.type == "sliderfloat")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        code->pushwidth(obj.width);
+        //static float f1 = 0.123f;
+        //ImGui::SliderFloat("slider float", &f1, 0.0f, 1.0f, "ratio = %.3f");
+        std::string var = StateVar(ctx, obj, code, fmt::format("float f1{0} = 0.123f",obj.id));
+        code->text(idscope);
+        code->text(fmt::format("\tImGui::SliderFloat({}, &{}, 0.0f, 1.0f, \"ratio = %.3f\");\n",label,var));
+        code->text(idtail);
+        code->popwidth();
+    }
+
+    if (obj.type == "sliderfloatlog")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        code->pushwidth(obj.width);
+        //static float f2 = 0.0f;
+        //ImGui::SliderFloat("slider float (log)", &f2, -10.0f, 10.0f, "%.4f", ImGuiSliderFlags_Logarithmic);
+        std::string var = StateVar(ctx, obj, code, fmt::format("float f2{0} = 0.0f",obj.id));
+        code->text(idscope);
+        code->text(fmt::format("\tImGui::SliderFloat({}, &{}, -10.0f, 10.0f, \"%.4f\", ImGuiSliderFlags_Logarithmic);\n",label,var));
+        code->text(idtail);
+        code->popwidth();
+    }
+
+    if (obj.type == "sliderangle")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        code->pushwidth(obj.width);
+        //static float angle = 0.0f;
+        //ImGui::SliderAngle("slider angle", &angle);
+        std::string var = StateVar(ctx, obj, code, fmt::format("float angle{0} = 0.0f",obj.id));
+        code->text(idscope);
+        code->text(fmt::format("\tImGui::SliderAngle({}, &{});\n",label,var));
+        code->text(idtail);
+        code->popwidth();
+    }
+
+    if (obj.type == "color1")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        //static float col1[3] = {1.0f, 0.0f, 0.2f};
+        //ImGui::ColorEdit3(label.c_str(), col1, ImGuiColorEditFlags_NoInputs);
+        std::string var = StateVar(ctx, obj, code, fmt::format("float col1{0}[3] = {{1.0f, 0.0f, 0.2f}}",obj.id));
+        code->text(idscope);
+        code->text(fmt::format("\tImGui::ColorEdit3({}, {}, ImGuiColorEditFlags_NoInputs);\n",label,var));
+        code->text(idtail);
+        code->blank();
+    }
+
+    if (obj.type == "color2")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        code->pushwidth(obj.width);
+        //static float col2[3] = {1.0f, 0.0f, 0.2f};
+        //ImGui::ColorEdit3(label.c_str(), col2);
+        std::string var = StateVar(ctx, obj, code, fmt::format("float col2{0}[3] = {{1.0f, 0.0f, 0.2f}}",obj.id));
+        code->text(idscope);
+        code->text(fmt::format("\tImGui::ColorEdit3({}, {});\n",label,var));
+        code->text(idtail);
+        code->blank();
+        code->popwidth();
+    }
+
+    if (obj.type == "color3")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        code->pushwidth(obj.width);
+        //static float col3[4] = {0.4f, 0.7f, 0.0f, 0.5f};
+        //ImGui::ColorEdit4(label.c_str(), col3);
+        std::string var = StateVar(ctx, obj, code, fmt::format("float col3{0}[4] = {{0.4f, 0.7f, 0.0f, 0.5f}}",obj.id));
+        code->text(idscope);
+        code->text(fmt::format("\tImGui::ColorEdit4({}, {});\n",label,var));
+        code->text(idtail);
+        code->blank();
+        code->popwidth();
+    }
+
+    if (obj.type == "sameline")
+    {
+        if (ctx->staticlayout) {
+        code->sameline();
+        }
+    }
+
+    if (obj.type == "newline")
+    {
+        if (ctx->staticlayout) {
+        code->text("\tImGui::NewLine();\n\n");
+        }
+    }
+
+    if (obj.type == "separator")
+    {
+        if (ctx->staticlayout) {
+        code->text("\tImGui::Separator();\n\n");
+        }
+    }
+
+    if (obj.type == "progressbar")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        code->pushwidth(obj.width);
+        //static float progress = 0.0f;
+        //ImGui::ProgressBar(progress, ImVec2(0.0f, 0.0f));
+        std::string var = StateVar(ctx, obj, code, fmt::format("float progress{} = 0.0f",obj.id));
+        code->text(fmt::format("\tImGui::ProgressBar({}, ImVec2(0.0f, 0.0f));\n",var));
+        code->popwidth();
+    }
+
+    if (obj.type == "image")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        code->text(fmt::format("\tImGui::Image(atlas_pages[atlas[{0}].page], ImVec2({1},{2}), atlas[{0}].uv0, atlas[{0}].uv1); // {3}\n",
+                               ctx->atlas.find(obj.value_s), obj.size.x, obj.size.y, obj.value_s));
+    }
+
+    if (obj.type == "treenode")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        code->text(TreeOpen(obj, ctx));
+        code->text(TreeClose(obj, ctx));
+    }
+
+    if (obj.type == "textlog")
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        std::string decl;
+        std::string log = LogSource(obj, ctx, &decl);
+        code->decl(decl);
+        code->text(idscope);
+        code->text(fmt::format("\t{}.draw({}, ImVec2({}, {}));\n", log, label, obj.width, obj.size.y));
+        code->text(idtail);
+    }
+
+    if (IsPlot(obj.type))
+    {
+        if (!ctx->staticlayout) {
+        code->cursor(obj.pos);
+        }
+        code->pushwidth(obj.width);
+        std::string decl;
+        std::string series = PlotSeries(obj, ctx, &decl);
+        code->decl(decl);
+        code->text(idscope);
+        code->text(fmt::format("\tPlotMinMax({}, {}, ImVec2(0.0f, {}), {});\n",label, series, obj.size.y, (obj.type == "plothistogram") ? "true" : "false"));
+        code->text(idtail);
+        code->popwidth();
+    }
+
+}
+
+namespace
+{
+    enum TablePool
+    {
+        POOL_NONE,
+        POOL_BOOL,
+        POOL_INT,
+        POOL_FLOAT,
+        POOL_DOUBLE,
+        POOL_STR,
+        POOL_COUNT
+    };
+
+    struct TableKind
+    {
+        const char *            type;                                              // BaseObject::type
+        const char *            name;                                              // Enumerator in generated code
+        TablePool               pool;                                              // State pool used
+        int                     slots;                                             // Pool slots per widget
+        const char *            init;                                              // Slot initialiser
+        const char *            call;                                              // Statement(s) for the record
+    };
+
+    // Mirrors the snippets in Recreate(), reading labels/state from the tables instead of literals
+    const TableKind tablekinds[] = {
+        {"button",          "W_Button",          POOL_NONE,   0, "",
+         "ImGui::Button(labels[r.label], ImVec2(r.w, r.h));"},
+        {"radio",           "W_Radio",           POOL_BOOL,   1, "false",
+         "ImGui::RadioButton(labels[r.label], bools[r.slot]);"},
+        {"checkbox",        "W_Checkbox",        POOL_BOOL,   1, "false",
+         "ImGui::Checkbox(labels[r.label], &bools[r.slot]);"},
+        {"text",            "W_Text",            POOL_NONE,   0, "",
+         "ImGui::TextUnformatted(labels[r.label]);"},
+        {"bullet",          "W_Bullet",          POOL_NONE,   0, "",
+         "ImGui::Bullet();"},
+        {"arrow",           "W_Arrow",           POOL_NONE,   0, "",
+         "ImGui::ArrowButton(\"##left\", ImGuiDir_Left); ImGui::SameLine(); ImGui::ArrowButton(\"##right\", ImGuiDir_Right);"},
+        {"combo",           "W_Combo",           POOL_INT,    1, "0",
+         "ImGui::PushItemWidth(r.w); { const ItemList &l = lists[r.flags]; "
+         "if (ImGui::BeginCombo(labels[r.label], l.count ? l.items[ints[r.slot]] : NULL)) { ImGuiListClipper clipper; clipper.Begin(l.count); "
+         "while (clipper.Step()) for (int n = clipper.DisplayStart; n < clipper.DisplayEnd; n++) "
+         "if (ImGui::Selectable(l.items[n], n == ints[r.slot])) ints[r.slot] = n; ImGui::EndCombo(); } } ImGui::PopItemWidth();"},
+        {"listbox",         "W_ListBox",         POOL_INT,    1, "0",
+         "ImGui::PushItemWidth(r.w); ImGui::ListBox(labels[r.label], &ints[r.slot], lists[r.flags].items, lists[r.flags].count); ImGui::PopItemWidth();"},
+        {"textinput",       "W_InputText",       POOL_STR,    1, nullptr,
+         "ImGui::PushItemWidth(r.w); ImGui::InputText(labels[r.label], strs[r.slot], IM_ARRAYSIZE(strs[r.slot])); ImGui::PopItemWidth();"},
+        {"inputint",        "W_InputInt",        POOL_INT,    1, "123",
+         "ImGui::PushItemWidth(r.w); ImGui::InputInt(labels[r.label], &ints[r.slot]); ImGui::PopItemWidth();"},
+        {"inputfloat",      "W_InputFloat",      POOL_FLOAT,  1, "0.001f",
+         "ImGui::PushItemWidth(r.w); ImGui::InputFloat(labels[r.label], &floats[r.slot], 0.01f, 1.0f, \"%.3f\"); ImGui::PopItemWidth();"},
+        {"inputdouble",     "W_InputDouble",     POOL_DOUBLE, 1, "999999.00000001",
+         "ImGui::PushItemWidth(r.w); ImGui::InputDouble(labels[r.label], &doubles[r.slot], 0.01f, 1.0f, \"%.8f\"); ImGui::PopItemWidth();"},
+        {"inputscientific", "W_InputScientific", POOL_FLOAT,  1, "1.e10f",
+         "ImGui::PushItemWidth(r.w); ImGui::InputFloat(labels[r.label], &floats[r.slot], 0.0f, 0.0f, \"%e\"); ImGui::PopItemWidth();"},
+        {"inputfloat3",     "W_InputFloat3",     POOL_FLOAT,  4, "0.10f, 0.20f, 0.30f, 0.44f",
+         "ImGui::PushItemWidth(r.w); ImGui::InputFloat3(labels[r.label], &floats[r.slot]); ImGui::PopItemWidth();"},
+        {"dragint",         "W_DragInt",         POOL_INT,    1, "50",
+         "ImGui::PushItemWidth(r.w); ImGui::DragInt(labels[r.label], &ints[r.slot], 1); ImGui::PopItemWidth();"},
+        {"dragint100",      "W_DragInt100",      POOL_INT,    1, "42",
+         "ImGui::PushItemWidth(r.w); ImGui::DragInt(labels[r.label], &ints[r.slot], 1, 0, 100, \"%d%%\", ImGuiSliderFlags_AlwaysClamp); ImGui::PopItemWidth();"},
+        {"dragfloat",       "W_DragFloat",       POOL_FLOAT,  1, "1.00f",
+         "ImGui::PushItemWidth(r.w); ImGui::DragFloat(labels[r.label], &floats[r.slot], 0.005f); ImGui::PopItemWidth();"},
+        {"dragfloatsmall",  "W_DragFloatSmall",  POOL_FLOAT,  1, "0.0067f",
+         "ImGui::PushItemWidth(r.w); ImGui::DragFloat(labels[r.label], &floats[r.slot], 0.0001f, 0.0f, 0.0f, \"%.06f ns\"); ImGui::PopItemWidth();"},
+        {"sliderint",       "W_SliderInt",       POOL_INT,    1, "0",
+         "ImGui::PushItemWidth(r.w); ImGui::SliderInt(labels[r.label], &ints[r.slot], -1, 3); ImGui::PopItemWidth();"},
+        {"sliderfloat",     "W_SliderFloat",     POOL_FLOAT,  1, "0.123f",
+         "ImGui::PushItemWidth(r.w); ImGui::SliderFloat(labels[r.label], &floats[r.slot], 0.0f, 1.0f, \"ratio = %.3f\"); ImGui::PopItemWidth();"},
+        {"sliderfloatlog",  "W_SliderFloatLog",  POOL_FLOAT,  1, "0.0f",
+         "ImGui::PushItemWidth(r.w); ImGui::SliderFloat(labels[r.label], &floats[r.slot], -10.0f, 10.0f, \"%.4f\", ImGuiSliderFlags_Logarithmic); ImGui::PopItemWidth();"},
+        {"sliderangle",     "W_SliderAngle",     POOL_FLOAT,  1, "0.0f",
+         "ImGui::PushItemWidth(r.w); ImGui::SliderAngle(labels[r.label], &floats[r.slot]); ImGui::PopItemWidth();"},
+        {"color1",          "W_Color1",          POOL_FLOAT,  3, "1.0f, 0.0f, 0.2f",
+         "ImGui::ColorEdit3(labels[r.label], &floats[r.slot], ImGuiColorEditFlags_NoInputs);"},
+        {"color2",          "W_Color2",          POOL_FLOAT,  3, "1.0f, 0.0f, 0.2f",
+         "ImGui::PushItemWidth(r.w); ImGui::ColorEdit3(labels[r.label], &floats[r.slot]); ImGui::PopItemWidth();"},
+        {"color3",          "W_Color3",          POOL_FLOAT,  4, "0.4f, 0.7f, 0.0f, 0.5f",
+         "ImGui::PushItemWidth(r.w); ImGui::ColorEdit4(labels[r.label], &floats[r.slot]); ImGui::PopItemWidth();"},
+        {"sameline",        "W_SameLine",        POOL_NONE,   0, "",
+         "ImGui::SameLine();"},
+        {"newline",         "W_NewLine",         POOL_NONE,   0, "",
+         "ImGui::NewLine();"},
+        {"separator",       "W_Separator",       POOL_NONE,   0, "",
+         "ImGui::Separator();"},
+        {"progressbar",     "W_ProgressBar",     POOL_FLOAT,  1, "0.0f",
+         "ImGui::PushItemWidth(r.w); ImGui::ProgressBar(floats[r.slot], ImVec2(0.0f, 0.0f)); ImGui::PopItemWidth();"},
+        {"plotlines",       "W_PlotLines",       POOL_NONE,   0, "",
+         "ImGui::PushItemWidth(r.w); PlotMinMax(labels[r.label], series[r.slot].values, series[r.slot].count, ImVec2(0.0f, r.h), false); ImGui::PopItemWidth();"},
+        {"plothistogram",   "W_PlotHistogram",   POOL_NONE,   0, "",
+         "ImGui::PushItemWidth(r.w); PlotMinMax(labels[r.label], series[r.slot].values, series[r.slot].count, ImVec2(0.0f, r.h), true); ImGui::PopItemWidth();"},
+        {"image",           "W_Image",           POOL_NONE,   0, "",
+         "ImGui::Image(atlas_pages[atlas[r.slot].page], ImVec2(r.w, r.h), atlas[r.slot].uv0, atlas[r.slot].uv1);"},
+        {"textlog",         "W_TextLog",         POOL_NONE,   0, "",
+         "logs[r.slot]->draw(labels[r.label], ImVec2(r.w, r.h));"},
+        {"treenode",        "W_TreeNode",        POOL_NONE,   0, "",
+         "ImGui::BeginGroup(); if (ImGui::TreeNodeEx(labels[r.label], r.flags ? ImGuiTreeNodeFlags_DefaultOpen : 0)) flow++; "
+         "else { ImGui::EndGroup(); i += r.slot; }"},
+        {"lazytree",        "W_LazyTree",        POOL_NONE,   0, "",
+         "trees[r.slot]->draw();"},
+        {"treepop",         "W_TreePop",         POOL_NONE,   0, "",
+         "ImGui::TreePop(); ImGui::EndGroup(); flow--;"},
+        {"child",           "W_BeginChild",      POOL_NONE,   0, "",
+         "ImGui::BeginChild((ImGuiID)r.slot, ImVec2(r.w, r.h), r.flags != 0);"},
+        {"endchild",        "W_EndChild",        POOL_NONE,   0, "",
+         "ImGui::EndChild();"},
+    };
+
+    const int tablekinds_count = IM_ARRAYSIZE(tablekinds);
+
+    int FindTableKind(const std::string &type)
+    {
+        for (int k = 0; k < tablekinds_count; k++)
+        {
+            if (type == tablekinds[k].type) return k;
+        }
+        return -1;
+    }
+
+    // Call of a table kind whose pool holds pointers (some slots are bound to data fields): the pool's elements
+    // are dereferenced instead of taken the address of, and string sizes come from a table of their own
+    std::string PointerCall(const std::string &call, const std::string &pool)
+    {
+        std::string text = call;
+        auto replace = [&text](const std::string &from, const std::string &to)
+        {
+            for (size_t at = text.find(from); at != std::string::npos; at = text.find(from, at + to.size()))
+                text.replace(at, from.size(), to);
+        };
+        replace(fmt::format("IM_ARRAYSIZE({}[r.slot])", pool), "\x02");
+        replace(fmt::format("&{}[r.slot]", pool), "\x01");
+        if (pool != "strs") // a char array slot already passes as its pointer
+            replace(fmt::format("{}[r.slot]", pool), fmt::format("*{}[r.slot]", pool));
+        replace("\x01", fmt::format("{}[r.slot]", pool));
+        replace("\x02", "sizes[r.slot]");
+        return text;
+    }
+
+    struct TableBuilder
+    {
+        bool                    staticlayout               = false;
+        bool                    hashedids                  = false;
+        ImGuiID                 seed                       = 0;
+        std::string             records                    = {};
+        std::string             pools[POOL_COUNT]          = {};
+        int                     poolsize[POOL_COUNT]       = {};
+        std::vector<std::string> fields[POOL_COUNT]        = {};                   // Per slot: data field, "" = own
+        bool                    bound[POOL_COUNT]          = {};                   // Pool has a bound slot
+        std::vector<std::string> labels                    = {};
+        std::map<std::string, int> labelidx                = {};
+        bool                    used[IM_ARRAYSIZE(tablekinds)] = {};
+        int                     count                      = 0;
+        ImStudio::GeneratorContext *ctx                    = nullptr;
+        std::string             series                     = {};                   //-- Plot data, read every frame
+        std::string             seriesdecls                = {};                   //  | (slot = index)
+        int                     seriescount                = 0;                    //--
+        std::string             logs                       = {};                   //-- Text logs
+        std::string             logdecls                   = {};                   //  |
+        int                     logcount                   = 0;                    //--
+        std::string             trees                      = {};                   //-- Lazy tree sources
+        int                     treecount                  = 0;                    //--
+        std::string             lists                      = {};                   //-- Combo/listbox items,
+        std::string             listdecls                  = {};                   //  | one array per distinct
+        std::map<std::string, int> listidx                 = {};                   //  | list (flags = index)
+        int                     listcount                  = 0;                    //--
+
+        int list(const ImStudio::ItemList &items)
+        {
+            auto it = listidx.find(items.items);
+            if (it != listidx.end()) return it->second;
+            int idx = listcount++;
+            listidx[items.items] = idx;
+            if (items.count() == 0)
+            {
+                lists += "{NULL, 0}, ";
+                return idx;
+            }
+            listdecls += fmt::format("\tstatic const char *items_{}[] = {};\n", idx, ItemsInit(items));
+            lists     += fmt::format("{{items_{0}, IM_ARRAYSIZE(items_{0})}}, ", idx);
+            return idx;
+        }
+
+        int label(const std::string &text)
+        {
+            auto it = labelidx.find(text);
+            if (it != labelidx.end()) return it->second;
+            int idx = static_cast<int>(labels.size());
+            labels.push_back(text);
+            labelidx[text] = idx;
+            return idx;
+        }
+
+        void add(int kind, int flags, int labelid, int slot, ImGuiID id, ImVec2 pos, ImVec2 size)
+        {
+            used[kind] = true;
+            if (hashedids)
+                records += fmt::format("\t\t{{{}, {}, {}, {}, 0x{:08X}u, {}, {}, {}, {}}},\n",
+                                       tablekinds[kind].name, flags, labelid, slot, id, pos.x, pos.y, size.x, size.y);
+            else
+                records += fmt::format("\t\t{{{}, {}, {}, {}, {}, {}, {}, {}}},\n",
+                                       tablekinds[kind].name, flags, labelid, slot, pos.x, pos.y, size.x, size.y);
+            count++;
+        }
+
+        // Node record, the records of its children and a pop record. The node's slot is the number of records
+        // after it up to the pop, skipped while it is closed; its children are laid out statically.
+        void tree(const ImStudio::BaseObject &node, const std::vector<ImStudio::BaseObject> *children)
+        {
+            std::string outer  = records;
+            int         at     = count;
+            bool        layout = staticlayout;
+            ImGuiID     parent = seed;
+            records.clear();
+            staticlayout = true;
+            seed         = ImHashStr(node.label.c_str(), 0, parent);
+            if (children)
+            {
+                for (const ImStudio::BaseObject &cw : *children) add(cw);
+            }
+            if (!node.value_s.empty())
+            {
+                ctx->trees = true;
+                trees     += fmt::format("&({}), ", node.value_s);
+                add(FindTableKind("lazytree"), 0, 0, treecount++, 0, ImVec2(), ImVec2());
+            }
+            staticlayout = layout;
+            seed         = parent;
+
+            std::string inner = records;
+            records = outer;
+            add(FindTableKind("treenode"), node.value_b, label(node.label), count - at + 1, 0, node.pos, ImVec2());
+            records += inner;
+            add(FindTableKind("treepop"), 0, 0, 0, 0, ImVec2(), ImVec2());
+        }
+
+        void add(const ImStudio::BaseObject &obj)
+        {
+            if (obj.type == "treenode")
+            {
+                tree(obj, nullptr);
+                return;
+            }
+            int kind = FindTableKind(obj.type);
+            if (kind < 0) return;
+            const TableKind &tk = tablekinds[kind];
+            if ((!staticlayout) &&
+                ((obj.type == "sameline") || (obj.type == "newline") || (obj.type == "separator")))
+                return; // positional widgets only exist in static layouts
+
+            int slot = 0;
+            if (tk.pool != POOL_NONE)
+            {
+                slot = poolsize[tk.pool];
+                if (tk.pool == POOL_STR)
+                    pools[tk.pool] += fmt::format("\"{}\", ", obj.value_s);
+                else
+                    pools[tk.pool] += fmt::format("{}, ", tk.init);
+                poolsize[tk.pool] += tk.slots;
+                int  edited = (obj.type == "inputfloat3") ? 3 : tk.slots; // its 4th slot is padding
+                bool bind   = ImStudio::IsMemberPath(obj.binding);
+                for (int n = 0; n < tk.slots; n++)
+                {
+                    std::string field;
+                    if (bind && (n < edited))
+                        field = (tk.slots > 1) ? fmt::format("data.{}[{}]", obj.binding, n) : "data." + obj.binding;
+                    fields[tk.pool].push_back(field);
+                }
+                if (bind) bound[tk.pool] = ctx->bound = true;
+            }
+            if (ImStudio::IsPlot(obj.type))
+            {
+                std::string decl;
+                slot         = seriescount++;
+                series      += "{" + PlotSeries(obj, ctx, &decl) + "}, ";
+                seriesdecls += decl;
+            }
+            if (obj.type == "image")
+                slot = ctx->atlas.find(obj.value_s);
+            if (obj.type == "textlog")
+            {
+                std::string decl;
+                slot      = logcount++;
+                logs     += "&" + LogSource(obj, ctx, &decl) + ", ";
+                logdecls += decl;
+            }
+
+            int     labelid = 0;
+            ImGuiID id      = 0;
+            if ((obj.type == "button") || (obj.type == "text"))
+            {
+                labelid = label(obj.value_s);
+            }
+            else if (obj.type == "image")
+            {
+                labelid = 0; // unlabelled
+            }
+            else if (hashedids && (ImStudio::TrailingLabel(obj.type) || (obj.type == "textlog")) &&
+                     ImStudio::VisibleLabel(obj.label).empty())
+            {
+                labelid = label("");
+                id      = ImHashStr(obj.label.c_str(), 0, seed);
+            }
+            else
+            {
+                labelid = label(obj.label);
+            }
+
+            int flags = ((obj.type == "combo") || (obj.type == "listbox")) ? list(obj.itemlist) : 0;
+
+            bool   tall = ImStudio::IsPlot(obj.type) || (obj.type == "textlog");
+            ImVec2 size = ((obj.type == "button") || (obj.type == "image")) ? obj.size : ImVec2(obj.width, tall ? obj.size.y : 0);
+            add(kind, flags, labelid, slot, id, obj.pos, size);
+        }
+    };
+}
+
+void ImStudio::RecreateTables(BufferWindow* bw, std::string* output, GeneratorContext* ctx)
+{
+    const GeneratorOptions &opts = *ctx->opts;
+
+    TableBuilder tb;
+    tb.staticlayout = ctx->staticlayout;
+    tb.hashedids    = opts.hashedids;
+    tb.seed         = WindowSeed(0);
+    tb.ctx          = ctx;
+
+    for (Object &o : bw->objects)
+    {
+        if (o.type == "treenode")
+        {
+            tb.tree(o, &o.child.objects);
+        }
+        else if (o.type != "child")
+        {
+            tb.add(o);
+        }
+        else
+        {
+            tb.add(FindTableKind("child"), o.child.border, 0, o.child.id, 0,
+                   o.child.freerect.Min, o.child.freerect.GetSize());
+            tb.seed = WindowSeed(o.child.id);
+            for (BaseObject &cw : o.child.objects)
+            {
+                tb.add(cw);
+            }
+            tb.seed = WindowSeed(0);
+            tb.add(FindTableKind("endchild"), 0, 0, 0, 0, ImVec2(), ImVec2());
+        }
+    }
+
+    if (tb.count == 0) return;
+
+    std::string bfs;
+    bfs += "\t// Layout tables: one record per widget, submitted by the loop below\n";
+    bfs += "\tenum WidgetKind\n\t{\n";
+    for (int k = 0; k < tablekinds_count; k++)
+    {
+        if (tb.used[k]) bfs += fmt::format("\t\t{},\n", tablekinds[k].name);
+    }
+    bfs += "\t};\n";
+    if (opts.hashedids)
+        bfs += "\tstruct WidgetRecord { int kind, flags, label, slot; ImGuiID id; float x, y, w, h; };\n\n";
+    else
+        bfs += "\tstruct WidgetRecord { int kind, flags, label, slot; float x, y, w, h; };\n\n";
+
+    if (!tb.labels.empty())
+    {
+        bfs += "\tstatic const char *labels[] = {";
+        for (const std::string &l : tb.labels) bfs += fmt::format("\"{}\", ", l);
+        bfs += "};\n";
+    }
+    if (tb.listcount > 0)
+    {
+        bfs += tb.listdecls;
+        bfs += "\tstruct ItemList { const char *const *items; int count; };\n";
+        bfs += fmt::format("\tstatic const ItemList lists[] = {{{}}};\n", tb.lists);
+    }
+
+    static const char *pooltype[POOL_COUNT] = {"", "bool", "int", "float", "double", "char"};
+    static const char *poolname[POOL_COUNT] = {"", "bools", "ints", "floats", "doubles", "strs"};
+    for (int p = POOL_BOOL; p < POOL_COUNT; p++)
+    {
+        if (tb.poolsize[p] == 0) continue;
+        std::string dims = (p == POOL_STR) ? fmt::format("[{}][128]", tb.poolsize[p]) : fmt::format("[{}]", tb.poolsize[p]);
+        if (!tb.bound[p])
+        {
+            if (opts.statestruct)
+            {
+                ctx->members += fmt::format("\t{} {}{} = {{{}}};\n", pooltype[p], poolname[p], dims, tb.pools[p]);
+                bfs += fmt::format("\tauto &{0} = state.{0};\n", poolname[p]);
+            }
+            else
+            {
+                bfs += fmt::format("\tstatic {} {}{} = {{{}}};\n", pooltype[p], poolname[p], dims, tb.pools[p]);
+            }
+            continue;
+        }
+
+        // a slot per pointer, to the widget's own state or to its data field; the bound slots of the own array
+        // are left unused so the record slots stay the same
+        std::string own = opts.statestruct ? fmt::format("state.{}", poolname[p]) : fmt::format("own_{}", poolname[p]);
+        if (opts.statestruct)
+            ctx->members += fmt::format("\t{} {}{} = {{{}}};\n", pooltype[p], poolname[p], dims, tb.pools[p]);
+        else
+            bfs += fmt::format("\tstatic {} {}{} = {{{}}};\n", pooltype[p], own, dims, tb.pools[p]);
+        std::string refs;
+        std::string sizes;
+        for (size_t n = 0; n < tb.fields[p].size(); n++)
+        {
+            const std::string &field = tb.fields[p][n];
+            if (p == POOL_STR)
+            {
+                refs  += field.empty() ? fmt::format("{}[{}], ", own, n) : field + ", ";
+                sizes += field.empty() ? "128, " : fmt::format("IM_ARRAYSIZE({}), ", field);
+            }
+            else
+            {
+                refs  += field.empty() ? fmt::format("&{}[{}], ", own, n) : fmt::format("&{}, ", field);
+            }
+        }
+        bfs += fmt::format("\t{} *const {}[] = {{{}}};\n", pooltype[p], poolname[p], refs);
+        if (p == POOL_STR)
+            bfs += fmt::format("\tconst int sizes[] = {{{}}};\n", sizes);
+    }
+
+    if (tb.seriescount > 0)
+    {
+        bfs += tb.seriesdecls;
+        bfs += "\tstruct PlotSeries { const float *values; int count; };\n";
+        bfs += fmt::format("\tconst PlotSeries series[] = {{{}}};\n", tb.series);
+    }
+    if (tb.logcount > 0)
+    {
+        bfs += tb.logdecls;
+        bfs += fmt::format("\tTextLog *const logs[] = {{{}}};\n", tb.logs);
+    }
+    if (tb.treecount > 0)
+        bfs += fmt::format("\tLazyTree *const trees[] = {{{}}};\n", tb.trees);
+
+    bfs += "\n\tstatic constexpr WidgetRecord records[] = {\n";
+    bfs += tb.records;
+    bfs += "\t};\n\n";
+
+    // a closed tree node skips its records, so trees need the index; flow counts the open ones, whose records
+    // follow the node's row instead of their position
+    bool trees = tb.used[FindTableKind("treenode")];
+    if (trees)
+        bfs += "\tint flow = 0;\n\tfor (int i = 0; i < IM_ARRAYSIZE(records); i++)\n\t{\n\t\tconst WidgetRecord &r = records[i];\n";
+    else
+        bfs += "\tfor (const WidgetRecord &r : records)\n\t{\n";
+    if (!ctx->staticlayout)
+    {
+        std::vector<std::string> keep;
+        if (trees)
+            keep.push_back("(flow == 0)");
+        if (tb.used[FindTableKind("endchild")])
+            keep.push_back("(r.kind != W_EndChild)");
+        if (keep.empty())
+            bfs += "\t\tImGui::SetCursorPos(ImVec2(r.x, r.y));\n";
+        else if (keep.size() == 1)
+            bfs += fmt::format("\t\tif {} ImGui::SetCursorPos(ImVec2(r.x, r.y));\n", keep[0]);
+        else
+            bfs += fmt::format("\t\tif ({} && {}) ImGui::SetCursorPos(ImVec2(r.x, r.y));\n", keep[0], keep[1]);
+    }
+    if (opts.hashedids)
+        bfs += "\t\tif (r.id) ImGui::PushOverrideID(r.id);\n";
+    bfs += "\t\tswitch (r.kind)\n\t\t{\n";
+    for (int k = 0; k < tablekinds_count; k++)
+    {
+        if (!tb.used[k]) continue;
+        const TableKind &tk = tablekinds[k];
+        std::string call = tb.bound[tk.pool] ? PointerCall(tk.call, poolname[tk.pool]) : std::string(tk.call);
+        bfs += fmt::format("\t\tcase {}: {} break;\n", tk.name, call);
+    }
+    bfs += "\t\t}\n";
+    if (opts.hashedids)
+        bfs += "\t\tif (r.id) ImGui::PopID();\n";
+    bfs += "\t}\n\n";
+
+    output->append(bfs);
+}
+
+namespace
+{
+    const char *regionbegin = "// USER CODE BEGIN ";
+    const char *regionend   = "// USER CODE END ";
+
+    // Empty guarded region; MergeUserRegions() carries its contents over on export
+    std::string UserRegion(const std::string &name, const char *indent)
+    {
+        return fmt::format("{0}{1}{2}\n{0}{3}{2}\n\n", indent, regionbegin, name, regionend);
+    }
+
+    // One tab in front of every non-empty line
+    void AppendIndented(std::string* output, const std::string &text)
+    {
+        size_t line = 0;
+        while (line < text.size())
+        {
+            size_t next = text.find('\n', line);
+            if (next == std::string::npos) next = text.size() - 1;
+            if (next != line) *output += '\t';
+            output->append(text, line, next - line + 1);
+            line = next + 1;
+        }
+    }
+
+    void RecreateChild(const ImStudio::Object &o, ImStudio::CodeList* code, ImStudio::GeneratorContext* ctx)
+    {
+        const ImStudio::TemplateSet *templates = ctx->opts->templates;
+        ImStudio::TemplateArgs args;
+        args.child        = &o.child;
+        args.window       = windowname;
+        args.staticlayout = ctx->staticlayout;
+
+        int section = templates ? templates->find("child") : -1;
+        if (section >= 0)
+        {
+            std::string text;
+            templates->emit(section, args, &text);
+            code->text(text, ImStudio::CODE_BEGINSCOPE);
+        }
+        else
+        {
+            if (!ctx->staticlayout) {
+            code->cursor(o.child.freerect.Min);
+            }
+            code->text(fmt::format("\tImGui::BeginChild({}, ImVec2({},{}), {});\n\n", o.child.id, o.child.freerect.GetSize().x, o.child.freerect.GetSize().y, o.child.border), ImStudio::CODE_BEGINSCOPE);
+        }
+        ctx->seed = ImStudio::WindowSeed(o.child.id);
+        for (auto i = o.child.objects.begin(); i != o.child.objects.end(); ++i)
+        {
+            const ImStudio::BaseObject &cw = *i;// child widget
+
+            ImStudio::Recreate(cw, code, ctx);
+            if (ctx->opts->userregions) code->text(UserRegion(cw.identifier, "\t"), ImStudio::CODE_REGION);
+
+        }
+        ctx->seed = ImStudio::WindowSeed(0);
+        section = templates ? templates->find("endchild") : -1;
+        std::string text = "\tImGui::EndChild();\n\n";
+        if (section >= 0)
+        {
+            text.clear();
+            templates->emit(section, args, &text);
+        }
+        code->text(text, ImStudio::CODE_ENDSCOPE);
+        if (ctx->opts->userregions) code->text(UserRegion(o.identifier, "\t"), ImStudio::CODE_REGION);
+    }
+
+    // Designed children of a tree node follow its row in a static layout, whatever the window's. They get a code
+    // list of their own, emitted indented into the TreeNodeEx() block; free layouts keep the block in a group so
+    // the rows start under the node rather than at the window edge.
+    void RecreateTree(const ImStudio::Object &o, ImStudio::CodeList* code, ImStudio::GeneratorContext* ctx)
+    {
+        bool    layout = ctx->staticlayout;
+        ImGuiID seed   = ctx->seed;
+        if (!layout) {
+        code->cursor(o.pos);
+        code->text("\tImGui::BeginGroup();\n");
+        }
+        code->text(TreeOpen(o, ctx), ImStudio::CODE_BEGINSCOPE);
+
+        ImStudio::CodeList children;
+        ctx->staticlayout = true;
+        ctx->seed         = ImHashStr(o.label.c_str(), 0, seed);
+        for (const ImStudio::BaseObject &cw : o.child.objects)
+        {
+            ImStudio::Recreate(cw, &children, ctx);
+            if (ctx->opts->userregions) children.text(UserRegion(cw.identifier, "\t"), ImStudio::CODE_REGION);
+        }
+        ctx->staticlayout = layout;
+        ctx->seed         = seed;
+        if (ctx->opts->optimize)
+        {
+            // counted once more, as emitted text, by the enclosing list's optimize()
+            ImStudio::CodeStats stats;
+            children.optimize(&stats);
+            ctx->stats.passes += stats.passes;
+            ctx->stats.before += stats.before - stats.after;
+        }
+        std::string body;
+        children.emit(&body);
+        std::string text;
+        AppendIndented(&text, body);
+        code->text(text);
+
+        std::string close = TreeClose(o, ctx);
+        if (!layout) close.insert(close.size() - 1, "\tImGui::EndGroup();\n");
+        code->text(close, ImStudio::CODE_ENDSCOPE);
+        if (ctx->opts->userregions) code->text(UserRegion(o.identifier, "\t"), ImStudio::CODE_REGION);
+    }
+
+    struct CodePart
+    {
+        std::string             name                       = {};                   // Stable part name (file/function)
+        ImStudio::CodeList      code                       = {};                   // Widget code IR
+        std::string             body                       = {};                   // Widget code
+    };
+
+    // Window body, split per container and per opts.splitsize widget ids when opts.split is set. Loose widgets are
+    // grouped by id / splitsize rather than by count, so adding or deleting a widget leaves the other parts (and
+    // their names) as they were.
+    void CollectParts(ImStudio::BufferWindow* bw, ImStudio::GeneratorContext* ctx, std::vector<CodePart>* parts)
+    {
+        const ImStudio::GeneratorOptions &opts = *ctx->opts;
+        parts->assign(1, CodePart());
+        ImStudio::CollectImages(bw, &ctx->atlas);
+        ctx->atlas.pack();
+        if (opts.tables)
+        {
+            ImStudio::RecreateTables(bw, &parts->back().body, ctx);
+            return;
+        }
+
+        int key = -1;
+        for (auto i = bw->objects.begin(); i != bw->objects.end(); ++i)
+        {
+            ImStudio::Object &o = *i;
+            bool container = ImStudio::IsContainer(o.type);
+            int  k         = (opts.splitsize > 0) ? o.id / opts.splitsize : 0;
+
+            if (opts.split && !parts->back().code.ops.empty() && (container || (k != key)))
+                parts->emplace_back();
+            if (parts->back().code.ops.empty())
+                parts->back().name = container ? o.identifier : fmt::format("part{}", k);
+
+            ImStudio::CodeList *code = &parts->back().code;
+            if (!container)
+            {
+                ImStudio::Recreate(o, code, ctx);
+                if (opts.userregions) code->text(UserRegion(o.identifier, "\t"), ImStudio::CODE_REGION);
+                key = k;
+            }
+            else
+            {
+                if (o.type == "child") RecreateChild(o, code, ctx);
+                else                   RecreateTree(o, code, ctx);
+                if (opts.split) parts->emplace_back();
+                key = -1;
+            }
+        }
+        if (parts->size() > 1 && parts->back().code.ops.empty()) parts->pop_back();
+
+        // loose runs sharing a key (split by a container) get a suffix
+        std::map<std::string, int> seen;
+        for (CodePart &part : *parts)
+        {
+            int n = seen[part.name]++;
+            if (n > 0) part.name += fmt::format("_{}", n);
+
+            if (opts.optimize) part.code.optimize(&ctx->stats, &part == &parts->back());
+            part.code.emit(&part.body);
+        }
+    }
+
+    // Window state + SetNextWindowSize + Begin/End around body, unindented
+    std::string WindowBlock(ImStudio::BufferWindow* bw, const ImStudio::GeneratorOptions &opts, std::string body)
+    {
+        if (opts.userregions)
+        {
+            body += "\n";
+            body += UserRegion("window", "\t");
+        }
+
+        std::string block;
+        const ImStudio::TemplateSet *templates = opts.templates;
+        ImStudio::TemplateArgs args;
+        args.window     = windowname;
+        args.windowsize = bw->size;
+        if (templates && (templates->prologue >= 0) && (templates->epilogue >= 0))
+        {
+            templates->emit(templates->prologue, args, &block);
+            block += body;
+            templates->emit(templates->epilogue, args, &block);
+            return block;
+        }
+
+        if (!opts.statestruct)
+            block += "static bool window = true;\n";
+        block += fmt::format("ImGui::SetNextWindowSize(ImVec2({},{}));\n", bw->size.x, bw->size.y);
+        block += "//!! You might want to use these ^^ values in the OS window instead, and add the ImGuiWindowFlags_NoTitleBar flag in the ImGui window !!\n\n";
+        if (opts.statestruct)
+        {
+            if (opts.hashedids) block += fmt::format("if (ImGui::Begin(\"{}\", &state.window))\n{{\n\n", windowname);
+            else                block += "if (ImGui::Begin(name, &state.window))\n{\n\n";
+        }
+        else
+        {
+            block += fmt::format("if (ImGui::Begin(\"{}\", &window))\n{{\n\n", windowname);
+        }
+        block += body;
+        block += "\n\tImGui::End();\n}\n";
+        return block;
+    }
+
+    std::string StateStruct(const ImStudio::GeneratorContext &ctx)
+    {
+        std::string text;
+        text += "// All widget state of the window; instantiate once per window you want to show\n";
+        text += "struct WindowState\n{\n\tbool window = true;\n";
+        text += ctx.members;
+        text += "};\n\n";
+        return text;
+    }
+
+    // Parameters of DrawWindow() and its parts: the state struct, then the data struct of bound widgets
+    std::string DrawParams(const ImStudio::GeneratorOptions &opts, bool bound)
+    {
+        std::string params = opts.statestruct ? "WindowState &state" : "";
+        if (bound) params += fmt::format("{}{} &data", params.empty() ? "" : ", ", opts.datastruct);
+        return params;
+    }
+
+    // DrawWindow() signature; the default argument only goes into declarations
+    std::string DrawSignature(const ImStudio::GeneratorOptions &opts, bool bound, bool declaration)
+    {
+        std::string params = DrawParams(opts, bound);
+        if (!opts.statestruct || opts.hashedids) return fmt::format("void DrawWindow({})", params);
+        if (declaration) return fmt::format("void DrawWindow({}, const char *name = \"{}\")", params, windowname);
+        return fmt::format("void DrawWindow({}, const char *name)", params);
+    }
+
+    // What bound widgets need of the data struct: its header, or a declaration and a note where it has to be visible
+    std::string DataDecl(const ImStudio::GeneratorOptions &opts)
+    {
+        if (!opts.datainclude.empty()) return fmt::format("#include \"{}\"\n\n", opts.datainclude);
+        return fmt::format("// Bound widgets edit fields of your {0}: its definition must be visible to the widget code "
+                           "(set its header in Generator > Data Header)\nstruct {0};\n\n", opts.datastruct);
+    }
+
+    // Header, window source and one source per part; ctx is fresh, its totals and flags are left for the caller
+    void SplitFiles(std::vector<ImStudio::GeneratedFile>* files, ImStudio::BufferWindow* bw, ImStudio::GeneratorContext &ctx)
+    {
+        const ImStudio::GeneratorOptions &opts = *ctx.opts;
+        std::vector<CodePart> parts;
+        CollectParts(bw, &ctx, &parts);
+
+        const std::string base   = windowname;
+        const std::string param  = DrawParams(opts, ctx.bound);
+        std::string       arg    = opts.statestruct ? "state" : "";
+        if (ctx.bound) arg += arg.empty() ? "data" : ", data";
+        files->clear();
+
+        // header: the only file every part includes, kept free of widget code
+        ImStudio::GeneratedFile header;
+        header.name  = base + ".h";
+        header.text  = "#pragma once\n\n";
+        if (ctx.plots || ctx.logs || ctx.trees || !ctx.atlas.images.empty())
+            header.text += "#include \"imgui.h\"\n\n";
+        if (ctx.bound)
+            header.text += DataDecl(opts);
+        if (ctx.plots)
+            header.text += ImStudio::PlotHelper(false);
+        if (ctx.logs)
+            header.text += ImStudio::LogHelper(false);
+        if (ctx.trees)
+            header.text += ImStudio::TreeHelper(false);
+        if (!ctx.strings.strings.empty())
+            header.text += "// String table, defined in the window source\nextern const char *const strings[];\n\n";
+        if (!ctx.atlas.images.empty())
+            header.text += AtlasTypes(ctx.atlas) + "extern const AtlasImage atlas[]; // Defined in the window source\n\n";
+        if (opts.statestruct)
+            header.text += StateStruct(ctx);
+        if (opts.statestruct && opts.hashedids)
+            header.text += "// Precomputed IDs are seeded with the window name, so it is fixed here\n";
+        header.text += DrawSignature(opts, ctx.bound, true) + ";\n\n";
+        header.text += "// Window parts, one per source file, called in order by DrawWindow()\n";
+        for (const CodePart &part : parts)
+            header.text += fmt::format("void DrawWindow_{}({});\n", part.name, param);
+        if (opts.userregions)
+        {
+            header.text += "\n";
+            header.text += UserRegion("declarations", "");
+        }
+        files->push_back(header);
+
+        // window: Begin/End around the part calls
+        std::string calls;
+        for (const CodePart &part : parts)
+            calls += fmt::format("\tDrawWindow_{}({});\n", part.name, arg);
+        ImStudio::GeneratedFile window;
+        window.name  = base + ".cpp";
+        window.text  = fmt::format("#include \"imgui.h\"\n#include \"{}\"\n\n", header.name);
+        if (opts.userregions)
+            window.text += UserRegion("includes", "");
+        window.text += ctx.strings.decl("");
+        if (!ctx.atlas.images.empty())
+            window.text += AtlasTable(ctx.atlas, "");
+        window.text += DrawSignature(opts, ctx.bound, false) + "\n{\n";
+        AppendIndented(&window.text, WindowBlock(bw, opts, calls));
+        window.text += "}\n";
+        files->push_back(window);
+
+        for (const CodePart &part : parts)
+        {
+            ImStudio::GeneratedFile file;
+            file.name  = fmt::format("{}_{}.cpp", base, part.name);
+            file.text  = "#include \"imgui.h\"\n";
+            if (opts.hashedids)
+                file.text += "#include \"imgui_internal.h\"\n";
+            file.text += fmt::format("#include \"{}\"\n\n", header.name);
+            file.text += fmt::format("void DrawWindow_{}({})\n{{\n", part.name, param);
+            file.text += part.body;
+            file.text += "}\n";
+            files->push_back(file);
+        }
+
+        if (opts.cmakesnippet)
+        {
+            ImStudio::GeneratedFile cmake;
+            cmake.name  = base + ".cmake";
+            cmake.text  = "# Generated UI sources: include() this file, then\n";
+            cmake.text += "# target_sources(<target> PRIVATE ${GENERATED_UI_SOURCES})\n";
+            cmake.text += "set(GENERATED_UI_SOURCES\n";
+            for (const ImStudio::GeneratedFile &f : *files)
+                cmake.text += fmt::format("    ${{CMAKE_CURRENT_LIST_DIR}}/{}\n", f.name);
+            cmake.text += ")\n";
+            files->push_back(cmake);
+        }
+    }
+}
+
+void ImStudio::GenerateFiles(std::vector<GeneratedFile>* files, BufferWindow* bw, const GeneratorOptions& opts, CodeStats* stats)
+{
+    GeneratorContext ctx;
+    ctx.opts         = &opts;
+    ctx.staticlayout = bw->staticlayout;
+    ctx.seed         = WindowSeed(0);
+    SplitFiles(files, bw, ctx);
+    if (stats) *stats = ctx.stats;
+}
+
+void ImStudio::GenerateModule(std::vector<GeneratedFile>* files, BufferWindow* bw, const GeneratorOptions& opts)
+{
+    GeneratorOptions o = opts;
+    o.split        = true;
+    o.statestruct  = true;
+    o.cmakesnippet = false;
+    o.userregions  = false;
+
+    GeneratorContext ctx;
+    ctx.opts         = &o;
+    ctx.staticlayout = bw->staticlayout;
+    ctx.seed         = WindowSeed(0);
+    SplitFiles(files, bw, ctx);
+
+    // the host keeps the state allocated by the previous module while the struct is laid out the same: its members
+    // as generated (the data struct is user code, the host only compares sizes)
+    ImGuiID layout = ImHashStr(StateStruct(ctx).c_str());
+    GeneratedFile module;
+    module.name  = fmt::format("{}_module.cpp", windowname);
+    module.text  = fmt::format("#include \"imgui.h\"\n#include \"{}.h\"\n\n#include <cstddef>\n\n", windowname);
+    module.text += "// Hot reload entry points, looked up by the host with dlsym()\n";
+    module.text += "struct ModuleState\n{\n\tWindowState state;\n";
+    if (ctx.bound) module.text += fmt::format("\t{} data;\n", o.datastruct);
+    module.text += "};\n\n";
+    module.text += "extern \"C\"\n{\n";
+    module.text += fmt::format("\tunsigned ui_layout() {{ return 0x{:08X}u; }}\n", layout);
+    module.text += "\tsize_t ui_size() { return sizeof(ModuleState); }\n";
+    module.text += "\tvoid *ui_create() { return new ModuleState(); }\n";
+    module.text += "\tvoid ui_destroy(void *p) { delete static_cast<ModuleState *>(p); }\n";
+    module.text += fmt::format("\tvoid ui_draw(void *p) {{ ModuleState &m = *static_cast<ModuleState *>(p); DrawWindow({}); }}\n",
+                               ctx.bound ? "m.state, m.data" : "m.state");
+    module.text += "}\n";
+    files->push_back(module);
+}
+
+namespace
+{
+    // Start of the line after the one at [line]
+    size_t NextLine(const std::string &text, size_t line)
+    {
+        size_t next = text.find('\n', line);
+        return (next == std::string::npos) ? text.size() : next + 1;
+    }
+
+    // Name of a region marker line ("<indent>// USER CODE BEGIN <name>"), empty if the line is no such marker
+    std::string RegionMarker(const std::string &text, size_t line, size_t end, const char *marker)
+    {
+        while ((line < end) && ((text[line] == ' ') || (text[line] == '\t'))) line++;
+        size_t len = strlen(marker);
+        if ((end - line <= len) || (text.compare(line, len, marker) != 0)) return std::string();
+        while ((end > line + len) && isspace((unsigned char)text[end - 1])) end--;
+        return text.substr(line + len, end - line - len);
+    }
+
+    struct UserRegionText
+    {
+        int                     file                       = 0;                    // Existing file it was read from
+        size_t                  begin                      = 0;                    // BEGIN marker line
+        size_t                  body                       = 0;                    // First body line
+        size_t                  end                        = 0;                    // END marker line
+        size_t                  next                       = 0;                    // Line after END marker
+        bool                    used                       = false;                // Found in the new code
+    };
+
+    // Regions of all existing files of one export, so a widget moving to another file keeps its code
+    struct UserRegionPool
+    {
+        std::vector<std::string> texts                     = {};                   // Existing files
+        std::vector<int>        owners                     = {};                   // File their orphans go to
+        std::unordered_map<std::string, UserRegionText> regions = {};              // Name -> location
+        std::vector<std::string> order                     = {};                   // Names, in file order
+
+        void add(const std::string &existing)
+        {
+            int file = (int)texts.size();
+            texts.push_back(existing);
+            owners.push_back(file);
+            const std::string &text = texts.back();
+
+            std::string open;
+            UserRegionText current;
+            for (size_t line = 0; line < text.size();)
+            {
+                size_t next = NextLine(text, line);
+                if (open.empty())
+                {
+                    open          = RegionMarker(text, line, next, regionbegin);
+                    current.file  = file;
+                    current.begin = line;
+                    current.body  = next;
+                }
+                else if (RegionMarker(text, line, next, regionend) == open)
+                {
+                    current.end  = line;
+                    current.next = next;
+                    if (regions.emplace(open, current).second) order.push_back(open);
+                    open.clear();
+                }
+                line = next;
+            }
+        }
+
+        // Copies generated, swapping in the old body of every region it still has
+        std::string merge(const std::string &generated)
+        {
+            if (regions.empty()) return generated;
+
+            std::string merged;
+            merged.reserve(generated.size() + generated.size() / 8);
+            for (size_t line = 0; line < generated.size();)
+            {
+                size_t next = NextLine(generated, line);
+                merged.append(generated, line, next - line);
+
+                std::string name = RegionMarker(generated, line, next, regionbegin);
+                auto found = name.empty() ? regions.end() : regions.find(name);
+                line = next;
+                if (found == regions.end()) continue;
+
+                UserRegionText &r = found->second;
+                r.used = true;
+                merged.append(texts[r.file], r.body, r.end - r.body);
+                while ((line < generated.size()) && (RegionMarker(generated, line, NextLine(generated, line), regionend) != name))
+                    line = NextLine(generated, line);
+            }
+            return merged;
+        }
+
+        // Regions of deleted widgets are kept, disabled, at the end of the file they were in (or its owner, if that
+        // file is no longer generated)
+        void orphans(std::string* merged, int file) const
+        {
+            bool any = false;
+            for (const std::string &name : order)
+            {
+                const UserRegionText &r = regions.at(name);
+                if (r.used || (owners[r.file] != file) || (r.end == r.body)) continue;
+                if (!any) *merged += "\n#if 0 // USER CODE of widgets that no longer exist\n";
+                any = true;
+                merged->append(texts[r.file], r.begin, r.next - r.begin);
+            }
+            if (any) *merged += "#endif\n";
+        }
+    };
+}
+
+std::string ImStudio::MergeUserRegions(const std::string &generated, const std::string &existing)
+{
+    UserRegionPool pool;
+    pool.add(existing);
+    std::string merged = pool.merge(generated);
+    pool.orphans(&merged, 0);
+    return merged;
+}
+
+namespace
+{
+    const char *exportmanifest = ".imstudio-export"; // Names of the files the last export wrote, one per line
+
+    std::string ReadText(const std::string &path, bool *exists)
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::stringstream ss;
+        if (in) ss << in.rdbuf();
+        if (exists) *exists = (bool)in;
+        return ss.str();
+    }
+}
+
+bool ImStudio::WriteFiles(const std::vector<GeneratedFile>& files, const std::string &dir, int *changed, int *removed)
+{
+    if (changed) *changed = 0;
+    if (removed) *removed = 0;
+    auto pathof = [&dir](const std::string &name) { return dir.empty() ? name : dir + "/" + name; };
+
+    // keep hand-written regions (across all files), and leave files that would not change untouched
+    UserRegionPool pool;
+    std::vector<bool> exists(files.size(), false);
+    std::string       manifest;
+    std::unordered_set<std::string> names;
+    for (size_t n = 0; n < files.size(); n++)
+    {
+        bool found = false;
+        pool.add(ReadText(pathof(files[n].name), &found));
+        exists[n] = found;
+        manifest += files[n].name + "\n";
+        names.insert(files[n].name);
+    }
+
+    // files of the last export that are no longer generated (a container gone, a part renumbered): their regions
+    // are read too, so code in them moves to its widget's new file or into the orphans of the main source
+    int home = 0;
+    for (size_t n = 0; n < files.size(); n++)
+    {
+        const std::string &name = files[n].name;
+        if ((name.size() > 4) && (name.compare(name.size() - 4, 4, ".cpp") == 0))
+        {
+            home = (int)n;
+            break;
+        }
+    }
+    std::vector<std::string> gone;
+    bool        hadmanifest = false;
+    std::string previous    = ReadText(pathof(exportmanifest), &hadmanifest);
+    for (size_t line = 0; line < previous.size();)
+    {
+        size_t      next = NextLine(previous, line);
+        std::string name = previous.substr(line, next - line);
+        while (!name.empty() && isspace((unsigned char)name.back())) name.pop_back();
+        line = next;
+        if (name.empty() || names.count(name)) continue;
+
+        bool found = false;
+        std::string text = ReadText(pathof(name), &found);
+        if (!found) continue;
+        pool.add(text);
+        pool.owners.back() = home;
+        gone.push_back(name);
+        names.insert(name);
+    }
+
+    std::vector<std::string> merged(files.size());
+    for (size_t n = 0; n < files.size(); n++)
+        merged[n] = pool.merge(files[n].text);
+
+    for (size_t n = 0; n < files.size(); n++)
+    {
+        const GeneratedFile &f = files[n];
+        std::string path = pathof(f.name);
+        std::string &text = merged[n];
+        pool.orphans(&text, (int)n);
+        if (exists[n] && (text == pool.texts[n])) continue;
+
+        FILE *fp = fopen(path.c_str(), "wb");
+        if (!fp) return false;
+        bool ok = fwrite(text.data(), 1, text.size(), fp) == text.size();
+        ok = (fclose(fp) == 0) && ok;
+        if (!ok) return false;
+        if (changed) (*changed)++;
+    }
+
+    // only now that their regions are safe elsewhere; a build globbing the directory would still compile them
+    for (const std::string &name : gone)
+        if ((remove(pathof(name).c_str()) == 0) && removed) (*removed)++;
+
+    if (hadmanifest && (previous == manifest)) return true;
+    FILE *fp = fopen(pathof(exportmanifest).c_str(), "wb");
+    if (!fp) return false;
+    bool ok = fwrite(manifest.data(), 1, manifest.size(), fp) == manifest.size();
+    return (fclose(fp) == 0) && ok;
+}
+
+namespace
+{
+    // Bind fields the generator ignores, the widgets keep state of their own
+    std::string BindingWarnings(const ImStudio::BufferWindow &bw)
+    {
+        std::string warnings;
+        auto check = [&warnings](const ImStudio::BaseObject &o)
+        {
+            if (o.binding.empty() || ImStudio::IsMemberPath(o.binding)) return;
+            warnings += fmt::format("//!! {}: Bind \"{}\" is not a field path (name, .name, [index]), ignored !!\n",
+                                    o.identifier, o.binding);
+        };
+        for (const ImStudio::Object &o : bw.objects)
+        {
+            check(o);
+            for (const ImStudio::BaseObject &cw : o.child.objects)
+                check(cw);
+        }
+        return warnings.empty() ? warnings : warnings + "\n";
+    }
+}
+
+void ImStudio::GenerateCode(std::string* output, BufferWindow* bw, const GeneratorOptions& opts, const IdCheck* ids)
+{
+#ifdef __EMSCRIPTEN__
+    *output  = "/*\nGENERATED CODE | READ-ONLY\nCopy by clicking the above button\n*/\n\n";
+#else
+    *output  = "/*\nGENERATED CODE | READ-ONLY\nYou can directly copy from here, or from File > Export to clipboard\n*/\n\n";
+#endif
+    if (opts.hashedids)
+        *output += "//!! Precomputed IDs use ImGui::PushOverrideID(), declared in imgui_internal.h !!\n\n";
+    *output += BindingWarnings(*bw);
+
+    std::string code;
+    CodeStats   stats;
+    if (opts.split)
+    {
+        std::vector<GeneratedFile> files;
+        GenerateFiles(&files, bw, opts, &stats);
+        for (const GeneratedFile &f : files)
+        {
+            code += fmt::format("// ---------------- {} ----------------\n", f.name);
+            code += f.text;
+            code += "\n";
+        }
+    }
+    else
+    {
+        GeneratorContext ctx;
+        ctx.opts         = &opts;
+        ctx.staticlayout = bw->staticlayout;
+        ctx.seed         = WindowSeed(0);
+
+        std::vector<CodePart> parts;
+        CollectParts(bw, &ctx, &parts);
+        stats = ctx.stats;
+        std::string helpers;
+        if (ctx.bound && !opts.statestruct)
+            helpers += fmt::format("\t// Bound widgets edit fields of data: a {} & of that name where this is pasted\n\n", opts.datastruct);
+        if (ctx.plots)
+            helpers += PlotHelper(true);
+        if (ctx.logs && !opts.statestruct)
+            helpers += LogHelper(true); // a local struct; the state struct needs it at file scope
+        if (ctx.trees && !opts.statestruct)
+            helpers += TreeHelper(true);
+        std::string block = WindowBlock(bw, opts, helpers + parts.front().body);
+
+        code += ctx.strings.decl("static ");
+        if (!ctx.atlas.images.empty())
+            code += AtlasTypes(ctx.atlas) + AtlasTable(ctx.atlas, "static ");
+        if (!opts.statestruct)
+        {
+            code += block;
+        }
+        else
+        {
+            if (ctx.bound)
+                code += DataDecl(opts);
+            if (ctx.logs)
+                code += LogHelper(false);
+            if (ctx.trees)
+                code += TreeHelper(false);
+            code += StateStruct(ctx);
+            if (opts.hashedids)
+                code += "// Precomputed IDs are seeded with the window name, so it is fixed here\n";
+            code += DrawSignature(opts, ctx.bound, true) + "\n{\n";
+            AppendIndented(&code, block);
+            code += "}\n";
+        }
+    }
+    if (opts.optimize && !opts.tables)
+        *output += fmt::format("//!! Optimizer: {} passes, {} -> {} ImGui calls ({} fewer) !!\n\n",
+                               stats.passes, stats.before, stats.after, stats.before - stats.after);
+    *output += code;
+    if (!ids)
+    {
+        *output += "\n/*\nReminder: some widgets may have the same label \"##\" (if you didn't change it), and can lead to undesired ID collisions.\nMore info: https://github.com/ocornut/imgui/blob/master/docs/FAQ.md#q-about-the-id-stack-system\n*/\n";
+    }
+    else if (!ids->collisions.empty())
+    {
+        *output += "\n/*\nID collisions: these widgets share an ImGuiID and will react together, give them distinct labels (or \"##\" suffixes).\n";
+        for (const IdCollision &c : ids->collisions)
+        {
+            *output += fmt::format("  0x{:08X} \"{}\":", c.id, c.label);
+            for (size_t n = 0; (n < c.entries.size()) && (n < 16); n++)
+                *output += " " + ids->entries[c.entries[n]].identifier;
+            if (c.entries.size() > 16) *output += fmt::format(" (+{} more)", c.entries.size() - 16);
+            *output += "\n";
+        }
+        *output += "More info: https://github.com/ocornut/imgui/blob/master/docs/FAQ.md#q-about-the-id-stack-system\n*/\n";
+    }
+}
@@ -3,11 +3,168 @@
 #include "../includes.h"
 #include "object.h"
 #include "buffer.h"
+#include "codetemplate.h"
+#include "atlas.h"
+
+#include <map>
+#include <unordered_map>
 
 namespace ImStudio
 {
 
-    void Recreate(BaseObject obj, std::string* output, bool staticlayout);
-    void GenerateCode(std::string* output, BufferWindow* bw);
+    struct GeneratorOptions
+    {
+        bool                    tables                     = false;                // Data-driven layout tables
+        bool                    hashedids                  = false;                // Precomputed ImGuiID hashes
+        bool                    statestruct                = false;                // State struct + draw function
+        bool                    split                      = false;                // Split output into files
+        int                     splitsize                  = 64;                   // Loose widgets per file (0 = per container only)
+        bool                    cmakesnippet               = true;                 // CMake source list (split)
+        bool                    userregions                = false;                // Guarded user code regions
+        bool                    optimize                   = false;                // Peephole passes over the code IR
+        bool                    stringtable                = false;                // Deduplicated string literal table
+        std::string             datastruct                 = "AppData";            //-- Type of the struct widgets are
+        std::string             datainclude                = {};                   //-- bound to, and its header
+        const TemplateSet *     templates                  = nullptr;              // User code templates (null = built-in)
+    };
+
+    struct GeneratedFile
+    {
+        std::string             name                       = {};                   // File name, relative
+        std::string             text                       = {};                   // File contents
+    };
+
+    enum CodeOpKind
+    {
+        CODE_NONE,                                                                 // Removed by a pass
+        CODE_TEXT,                                                                 // Verbatim statements
+        CODE_DECL,                                                                 // Widget state declaration
+        CODE_CURSOR,                                                               // SetCursorPos(x, y)
+        CODE_PUSHWIDTH,                                                            // PushItemWidth(x), note in text
+        CODE_POPWIDTH,                                                             // PopItemWidth()
+        CODE_ITEMS,                                                                // Items array name = init
+        CODE_ITEMSCALL,                                                            // Statement using items "name"
+        CODE_SAMELINE,                                                             // SameLine()
+        CODE_BLANK,                                                                // Empty line
+        CODE_REGION,                                                               // User code region
+        CODE_BEGINSCOPE,                                                           // Child window begin
+        CODE_ENDSCOPE                                                              // Child window end
+    };
+
+    struct CodeOp
+    {
+        int                     kind                       = CODE_NONE;            // CodeOpKind
+        std::string             text                       = {};                   // Statement/note text
+        std::string             name                       = {};                   //--
+        std::string             init                       = {};                   //  | Items array
+        bool                    hoisted                    = false;                //  |
+        bool                    once                       = false;                //-- Static in place (long list)
+        ImVec2                  pos                        = {};                   // Cursor pos/item width (x)
+    };
+
+    struct CodeStats
+    {
+        int                     passes                     = 0;                    // Pass runs until fixpoint
+        int                     before                     = 0;                    // ImGui calls emitted naively
+        int                     after                      = 0;                    // ImGui calls after the passes
+    };
+
+    // Code IR of one function body: Recreate() appends, the passes rewrite, emit() prints
+    struct CodeList
+    {
+        std::vector<CodeOp>     ops                        = {};
+
+        void                    text                       (const std::string &text, int kind = CODE_TEXT);
+        void                    decl                       (const std::string &text);
+        void                    cursor                     (ImVec2 pos);
+        void                    pushwidth                  (float width, const char *note = "");
+        void                    popwidth                   ();
+        void                    items                      (const std::string &name, const std::string &init, bool once = false);
+        void                    itemscall                  (const std::string &text, const std::string &name);
+        void                    sameline                   ();
+        void                    blank                      ();
+
+        int                     calls                      () const;
+        void                    optimize                   (CodeStats* stats, bool last = true); // last: ends the window
+        void                    emit                       (std::string* output) const;
+    };
+
+    // Distinct string literals of one window, in order of first use
+    struct StringTable
+    {
+        std::vector<std::string>   strings                 = {};
+        std::map<std::string, int> index                   = {};                   // String -> slot
+        std::map<std::string, int> lists                   = {};                   // Joined item list -> first slot
+
+        int                     add                        (const std::string &text);
+        int                     addlist                    (const std::vector<std::string> &list);
+        std::string             decl                       (const char *storage) const;
+    };
+
+    struct IdEntry
+    {
+        int                     object                     = 0;                    // Object id
+        std::string             identifier                 = {};                   // Object identifier (type+id)
+        int                     source                     = 0;                    // What is hashed (label, value, ...)
+        std::string             label                      = {};                   // Label as hashed
+        ImGuiID                 seed                       = 0;                    // Window/child ID stack seed
+        ImGuiID                 id                         = 0;                    // Effective ImGuiID
+    };
+
+    struct IdCollision
+    {
+        ImGuiID                 id                         = 0;                    // Shared ImGuiID
+        std::string             label                      = {};                   // Label of the first widget
+        std::vector<size_t>     entries                    = {};                   // Colliding IdCheck entries
+    };
+
+    // Effective ImGuiID of every widget in the design: update() walks the objects after a change, rehashes only the
+    // labels that changed and regroups the collisions only when a shared ID gained or lost a widget
+    struct IdCheck
+    {
+        std::vector<IdEntry>    entries                    = {};                   // Per ID (1+ per widget), in design order
+        std::vector<IdCollision> collisions                = {};                   // Groups of 2+ widgets
+        std::unordered_map<ImGuiID, int> counts            = {};                   // Widgets per ID
+        int                     shared                     = 0;                    // IDs with 2+ widgets
+        bool                    regroup                    = false;                // A shared ID changed
+        int                     rehashed                   = 0;                    // Labels hashed by the last update
+
+        bool                    update                     (const BufferWindow &bw);
+    };
+
+    struct GeneratorContext
+    {
+        const GeneratorOptions *opts                       = nullptr;              // Options of this pass
+        bool                    staticlayout               = false;                // Static/linear layout
+        ImGuiID                 seed                       = 0;                    // ID stack seed of the parent window
+        std::string             members                    = {};                   // State struct members
+        CodeStats               stats                      = {};                   // Optimizer totals (optimize)
+        StringTable             strings                    = {};                   // Literals (stringtable)
+        bool                    plots                      = false;                // PlotHelper() is called
+        bool                    logs                       = false;                // LogHelper() is called
+        bool                    trees                      = false;                // TreeHelper() is called
+        bool                    bound                      = false;                // A widget edits a data field
+        Atlas                   atlas                      = {};                   // Image widgets, packed
+    };
+
+    ImGuiID     WindowSeed      (int childid);                                     // ID stack seed of window/child
+    bool        TrailingLabel   (const std::string &type);                         // Label drawn after the frame
+    std::string VisibleLabel    (const std::string &label);                        // Label up to "##"
+    bool        IsMemberPath    (const std::string &path);                         // Bind field: a.b[2].c
+
+    std::string StateDecl       (GeneratorContext* ctx, const std::string &decl);  // Widget state declaration
+    std::string StateVar        (GeneratorContext* ctx, const BaseObject &obj, CodeList* code, const std::string &decl);
+    std::string Literal         (GeneratorContext* ctx, const std::string &text);  // Quoted string or table entry
+    std::string PlotHelper      (bool lambda);                                     // PlotMinMax(), decimating plots
+    std::string LogHelper       (bool local);                                      // TextLog, line indexed text
+    std::string TreeHelper      (bool local);                                      // LazyTree, clipped lazy children
+
+    void Recreate(const BaseObject &obj, CodeList* code, GeneratorContext* ctx);
+    void RecreateTables(BufferWindow* bw, std::string* output, GeneratorContext* ctx);
+    void GenerateFiles(std::vector<GeneratedFile>* files, BufferWindow* bw, const GeneratorOptions& opts, CodeStats* stats = nullptr);
+    void GenerateModule(std::vector<GeneratedFile>* files, BufferWindow* bw, const GeneratorOptions& opts); // Split files + dlopen entry points
+    std::string MergeUserRegions(const std::string &generated, const std::string &existing);
+    bool WriteFiles(const std::vector<GeneratedFile>& files, const std::string &dir, int *changed = nullptr, int *removed = nullptr); // Removed: stale files of the last export
+    void GenerateCode(std::string* output, BufferWindow* bw, const GeneratorOptions& opts, const IdCheck* ids = nullptr);
 
-}
\ No newline at end of file
+}
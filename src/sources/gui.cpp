@@ -4,6 +4,385 @@
 #include "generator.h"
 #include "gui.h"
 
+namespace
+{
+    using namespace ImStudio;
+
+    const int thumbcols = 48;                                                      //-- Thumbnail grid
+    const int thumbrows = 32;                                                      //--
+
+    void Mark(std::vector<bool> *cells, ImVec2 window, ImVec2 min, ImVec2 max)
+    {
+        if ((window.x <= 0) || (window.y <= 0)) return;
+        int x0 = ImClamp((int)(min.x / window.x * thumbcols), 0, thumbcols - 1);
+        int y0 = ImClamp((int)(min.y / window.y * thumbrows), 0, thumbrows - 1);
+        int x1 = ImClamp((int)(max.x / window.x * thumbcols), x0, thumbcols - 1);
+        int y1 = ImClamp((int)(max.y / window.y * thumbrows), y0, thumbrows - 1);
+        for (int y = y0; y <= y1; y++)
+            for (int x = x0; x <= x1; x++)
+                (*cells)[y * thumbcols + x] = true;
+    }
+
+    // Coarse occupancy of a window, one rect per run of filled cells, so drawing it costs the same for any design size
+    std::vector<ImRect> Thumbnail(const BufferWindow &bw)
+    {
+        std::vector<bool> cells(thumbcols * thumbrows, false);
+        for (const Object &o : bw.objects)
+        {
+            if (o.type != "child")
+            {
+                Mark(&cells, bw.size, o.pos, ImVec2(o.pos.x + o.size.x, o.pos.y + o.size.y));
+                continue;
+            }
+            Mark(&cells, bw.size, o.child.freerect.Min, o.child.freerect.Max);
+        }
+        std::vector<ImRect> rects;
+        for (int y = 0; y < thumbrows; y++)
+        {
+            for (int x = 0; x < thumbcols; x++)
+            {
+                if (!cells[y * thumbcols + x]) continue;
+                int end = x;
+                while ((end + 1 < thumbcols) && cells[y * thumbcols + end + 1]) end++;
+                rects.push_back(ImRect((float)x / thumbcols, (float)y / thumbrows,
+                                       (float)(end + 1) / thumbcols, (float)(y + 1) / thumbrows));
+                x = end;
+            }
+        }
+        return rects;
+    }
+
+    // Thumbnail button of a window; focused windows get a caption only, their design is the viewport
+    bool ShowThumbnail(const DesignWindow &w, bool focused, ImVec2 size)
+    {
+        ImVec2      min = ImGui::GetCursorScreenPos();
+        ImVec2      max = ImVec2(min.x + size.x, min.y + size.y);
+        ImDrawList *dl  = ImGui::GetWindowDrawList();
+        bool clicked = ImGui::InvisibleButton(w.name.c_str(), size);
+        dl->AddRectFilled(min, max, IM_COL32(20, 23, 23, 255), 4.0f);
+        if (!focused)
+        {
+            for (const ImRect &r : w.thumbnail)
+                dl->AddRectFilled(ImLerp(min, max, r.Min), ImLerp(min, max, r.Max), IM_COL32(66, 150, 250, 110));
+        }
+        ImU32 border = focused ? IM_COL32(72, 115, 179, 255)
+                               : (ImGui::IsItemHovered() ? IM_COL32(200, 200, 200, 255) : IM_COL32(88, 88, 88, 255));
+        dl->AddRect(min, max, border, 4.0f, 0, focused ? 2.0f : 1.0f);
+        dl->AddText(ImVec2(min.x + 4, max.y - ImGui::GetTextLineHeight() - 2), IM_COL32(215, 215, 215, 255),
+                    w.name.c_str());
+        return clicked;
+    }
+
+    void ShowJob(JobState &job)
+    {
+        static const char spinner[] = "|/-\\";
+        ImGui::TextDisabled("%s", job.name.c_str());
+        ImGui::SameLine();
+        float progress = job.progress;
+        if (progress >= 0.0f)
+        {
+            ImGui::ProgressBar(progress, ImVec2(ImGui::GetFontSize() * 6, 0));
+        }
+        else
+        {
+            ImGui::TextDisabled("%c", spinner[static_cast<int>(ImGui::GetTime() * 10) & 3]);
+        }
+        ImGui::SameLine();
+        ImGui::PushID(&job);
+        if (ImGui::SmallButton("x")) job.cancel = true;
+        ImGui::PopID();
+        ImGui::SameLine();
+    }
+}
+
+void ImStudio::GUI::Init()
+{
+    NewDocument();
+
+    bw.events.subscribe([this](BaseObject *obj, const PropertyField *)
+    {
+        idstale     = true;
+        outputstale = true;
+        hotstale    = true;
+        if (child_minimap) minimap.update(obj);
+        else               minimap.stale = true;
+    });
+}
+
+void ImStudio::GUI::NewDocument()
+{
+    Document doc;
+    doc.name       = fmt::format("Document {}", documents.size() + 1);
+    doc.designpath = documents.empty() ? designpath : "design.imstudio";
+    doc.windows.emplace_back(new DesignWindow());
+    doc.windows[0]->name = "Window 1";
+    documents.push_back(std::move(doc));
+    if (documents.size() == 1) return; // the first one starts out focused, in bw
+
+    // a fresh window to focus: the listeners are the GUI's, the rest starts empty
+    DesignWindow &w = *documents.back().windows[0];
+    w.bw.events.listeners = bw.events.listeners;
+    w.bw.objects.reserve(2048);
+    w.bw.state = true;
+    Focus((int)documents.size() - 1, 0);
+}
+
+void ImStudio::GUI::NewWindow()
+{
+    Document &doc = documents[activedoc];
+    doc.windows.emplace_back(new DesignWindow());
+    DesignWindow &w = *doc.windows.back();
+    w.name = fmt::format("Window {}", doc.windows.size());
+    w.bw.events.listeners = bw.events.listeners;
+    w.bw.objects.reserve(2048);
+    w.bw.state = true;
+    Focus(activedoc, (int)doc.windows.size() - 1);
+}
+
+// Swaps the focused window's state into its slot (caching its thumbnail) and the target's out of its slot. Jobs of
+// the window going away are dropped; its file load/save must finish first, so a busy document cannot switch yet.
+bool ImStudio::GUI::Focus(int doc, int window)
+{
+    Document &from = documents[activedoc];
+    if ((doc == activedoc) && (window == from.focused)) return true;
+    if (loadjob.valid() || savejob.valid()) return false;
+
+    DesignWindow *slot = from.windows[from.focused].get();
+    for (int pass = 0; pass < 2; pass++)
+    {
+        std::swap(bw, slot->bw);
+        std::swap(idcheck, slot->idcheck);
+        std::swap(output, slot->output);
+        std::swap(selectid, slot->selectid);
+        std::swap(selectproparray, slot->selectproparray);
+        if (pass == 0) slot->thumbnail = Thumbnail(slot->bw);
+        if (pass == 0 && doc != activedoc)
+        {
+            std::swap(designpath, from.designpath);
+            std::swap(designbase, from.designbase);
+            std::swap(designpath, documents[doc].designpath);
+            std::swap(designbase, documents[doc].designbase);
+        }
+        slot = documents[doc].windows[window].get();
+    }
+    tabsync                   = tabsync || (doc != activedoc); // the tab bar follows on its next frame
+    activedoc                 = doc;
+    documents[doc].focused    = window;
+    if (livereload) designwatch.watch(designpath);
+
+    designjob.cancel();
+    designjob.reset();
+    minimap.stale = true;
+    idnext      = std::make_shared<IdCheck>(); // the old one may still be in the dropped job
+    idstale     = true;
+    outputstale = true;
+    hotstale    = true;
+    selectobj   = bw.getbaseobj(selectid);
+    jumpid      = selectid;
+    return true;
+}
+
+void ImStudio::GUI::ShowDocuments()
+{
+    int  closedoc = -1;
+    bool sync     = tabsync; // selection set from code: ignore the tab ImGui still shows this frame
+    tabsync       = false;
+    if (ImGui::BeginTabBar("documents", ImGuiTabBarFlags_FittingPolicyScroll))
+    {
+        for (int d = 0; d < (int)documents.size(); d++)
+        {
+            bool                open  = true;
+            ImGuiTabItemFlags   flags = (sync && (d == activedoc)) ? ImGuiTabItemFlags_SetSelected : 0;
+            ImGui::PushID(d);
+            bool selected = ImGui::BeginTabItem(documents[d].name.c_str(), (documents.size() > 1) ? &open : NULL, flags);
+            ImGui::PopID();
+            if (selected)
+            {
+                if ((d != activedoc) && !sync && !Focus(d, documents[d].focused)) tabsync = true; // busy, go back
+                ImGui::EndTabItem();
+            }
+            if (!open) closedoc = d;
+        }
+        if (ImGui::TabItemButton("+", ImGuiTabItemFlags_Trailing | ImGuiTabItemFlags_NoTooltip)) NewDocument();
+        ImGui::EndTabBar();
+    }
+
+    // the windows of the document: only the focused one is drawn, the others are cached thumbnails
+    Document &doc      = documents[activedoc];
+    ImVec2    thumb    = ImVec2(ImGui::GetFontSize() * 7, ImGui::GetFontSize() * 4.5f);
+    int       closewin = -1;
+    for (int w = 0; w < (int)doc.windows.size(); w++)
+    {
+        bool focused = (w == doc.focused);
+        ImGui::PushID(w);
+        ImGui::BeginGroup();
+        if (ShowThumbnail(*doc.windows[w], focused, thumb) && !focused) Focus(activedoc, w);
+        if (!focused && ImGui::BeginPopupContextItem("window"))
+        {
+            if (ImGui::MenuItem("Remove")) closewin = w;
+            ImGui::EndPopup();
+        }
+        ImGui::EndGroup();
+        ImGui::PopID();
+        ImGui::SameLine();
+    }
+    if (ImGui::Button("+##window", ImVec2(ImGui::GetFrameHeight(), thumb.y))) NewWindow();
+    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Add a buffer window to %s", doc.name.c_str());
+
+    if (closewin >= 0)
+    {
+        doc.windows.erase(doc.windows.begin() + closewin);
+        if (closewin < doc.focused) doc.focused--;
+    }
+    if ((closedoc >= 0) && ((closedoc != activedoc) || Focus((closedoc == 0) ? 1 : 0, documents[(closedoc == 0) ? 1 : 0].focused)))
+    {
+        documents.erase(documents.begin() + closedoc);
+        if (closedoc < activedoc) activedoc--;
+        tabsync = true;
+    }
+}
+
+// One design job at a time, on the snapshot published at the end of the last frame: a change while it runs cancels
+// it, and the next one starts from the newer snapshot once it has stopped. idcheck and idnext swap on every result,
+// so each stays an incremental base for update().
+void ImStudio::GUI::PollJobs()
+{
+    if (designjob.valid() && designjob.state->finished())
+    {
+        if (designjob.ready())
+        {
+            std::swap(idcheck, *idnext);
+            DesignOutput &result = designjob.get();
+            if (result.generated) output.swap(result.output);
+        }
+        designjob.reset();
+    }
+    if (exportjob.valid() && exportjob.state->finished())
+    {
+        exportstatus = exportjob.ready() ? exportjob.get() : "Export cancelled";
+        exportjob.reset();
+    }
+    if (hotjob.valid() && hotjob.state->finished())
+    {
+        if (hotjob.ready())
+        {
+            HotReloadBuild &build = hotjob.get();
+            if (build.ok)
+            {
+                hotstatus = fmt::format("Built in {:.2f} s, {} files changed", build.seconds, build.changed);
+            }
+            else
+            {
+                // the first errors are the ones worth reading in a menu
+                size_t end = 0;
+                for (int n = 0; (n < 12) && (end != std::string::npos); n++)
+                {
+                    end = build.log.find('\n', end);
+                    if (end != std::string::npos) end++;
+                }
+                hotstatus = "Build failed:\n" + build.log.substr(0, end);
+            }
+        }
+        hotjob.reset();
+    }
+    // one module build at a time: changes made while it runs go into the next one, from the newest snapshot
+    if (hotreload && hotstale && !hotjob.valid() && bw.snapshot())
+    {
+        std::shared_ptr<const DesignSnapshot> snap = bw.snapshot();
+        std::shared_ptr<TemplateSet>  tpl   = genopts.templates ? std::make_shared<TemplateSet>(templates) : nullptr;
+        GeneratorOptions              opts  = genopts;
+        std::string                   dir   = hotdir;
+        std::string                   imgui = imguidir;
+        hotjob = jobs.submit<HotReloadBuild>("Building module", [snap, tpl, opts, dir, imgui](JobState &)
+        {
+            GeneratorOptions o = opts;
+            if (o.templates) o.templates = tpl.get();
+            BufferWindow design;
+            std::vector<GeneratedFile> files;
+            snap->materialize(&design);
+            HotReloadProject(&files, &design, o, imgui);
+            return BuildModule(files, dir);
+        });
+        hotstale = false;
+    }
+
+    if (savejob.valid() && savejob.state->finished())
+    {
+        if (savejob.ready())
+        {
+            DesignIO &io = savejob.get();
+            designstatus = io.ok ? fmt::format("Saved {}", designpath) : io.error;
+            if (io.ok) designbase = io.base;
+        }
+        savejob.reset();
+    }
+    if (loadjob.valid() && loadjob.state->finished())
+    {
+        if (loadjob.ready())
+        {
+            DesignIO    &io    = loadjob.get();
+            DesignPatch &patch = io.patch;
+            bool         any   = !patch.changed.empty() || !patch.removed.empty() || patch.window;
+            if (!io.ok)
+                designstatus = io.error;
+            else if (any || !reloadlive)
+                designstatus = fmt::format("{}: {} changed, {} removed, {} unchanged", designpath,
+                                           patch.changed.size(), patch.removed.size(), patch.unchanged);
+            if (io.ok)
+            {
+                designbase = io.base;
+                if (ApplyDesign(&bw, &patch)) jumpid = selectid; // its index may have moved
+            }
+        }
+        loadjob.reset();
+    }
+    if (livereload && designwatch.changed() && !reloadpending)
+    {
+        reloadpending = true;
+        reloadlive    = true;
+    }
+    if (reloadpending && !loadjob.valid() && !savejob.valid() && bw.snapshot())
+    {
+        std::shared_ptr<const DesignSnapshot> snap = bw.snapshot();
+        std::shared_ptr<const DesignBase>     base = reloadlive ? designbase : nullptr;
+        std::string path = designpath;
+        loadjob = jobs.submit<DesignIO>("Loading", [snap, base, path](JobState &)
+        {
+            return LoadDesign(path, *snap, base.get());
+        });
+        reloadpending = false;
+    }
+
+    bool generate = outputstale && wksp_output;
+    std::shared_ptr<const DesignSnapshot> snap = bw.snapshot();
+    if ((!idstale && !generate) || !snap) return;
+    if (designjob.valid())
+    {
+        designjob.cancel();
+        return;
+    }
+
+    std::shared_ptr<TemplateSet>  tpl    = genopts.templates ? std::make_shared<TemplateSet>(templates) : nullptr;
+    std::shared_ptr<IdCheck>      ids    = idnext;
+    GeneratorOptions              opts   = genopts;
+    designjob = jobs.submit<DesignOutput>(generate ? "Generating" : "Checking IDs",
+                                          [snap, tpl, ids, opts, generate](JobState &job)
+    {
+        DesignOutput result;
+        BufferWindow design;
+        snap->materialize(&design);
+        ids->update(design);
+        if (!generate || job.cancelled()) return result;
+        GeneratorOptions o = opts;
+        if (o.templates) o.templates = tpl.get();
+        GenerateCode(&result.output, &design, o, ids.get());
+        result.generated = true;
+        return result;
+    });
+    idstale = false;
+    if (generate) outputstale = false;
+}
+
 // ANCHOR MENUBAR.DEFINITION
 void ImStudio::GUI::ShowMenubar()
 {
@@ -26,6 +405,87 @@ void ImStudio::GUI::ShowMenubar()
                 ImGui::LogText("%s", output.c_str());
                 ImGui::LogFinish();
             };
+            if (ImGui::BeginMenu("Export files", genopts.split))
+            {
+                ImGui::InputText("Directory", &exportdir);
+                if (ImGui::MenuItem("Write", NULL, false, !exportjob.running()))
+                {
+                    bw.publish(); // edits made earlier in this frame
+                    std::shared_ptr<const DesignSnapshot> snap = bw.snapshot();
+                    std::shared_ptr<TemplateSet>  tpl    = genopts.templates ? std::make_shared<TemplateSet>(templates) : nullptr;
+                    GeneratorOptions opts = genopts;
+                    std::string      dir  = exportdir;
+                    exportjob = jobs.submit<std::string>("Exporting", [snap, tpl, opts, dir](JobState &job)
+                    {
+                        GeneratorOptions o = opts;
+                        if (o.templates) o.templates = tpl.get();
+                        BufferWindow design;
+                        std::vector<GeneratedFile> files;
+                        int changed = 0;
+                        int removed = 0;
+                        job.progress = 0.0f;
+                        snap->materialize(&design);
+                        GenerateFiles(&files, &design, o);
+                        job.progress = 0.5f;
+                        if (job.cancelled()) return std::string("Export cancelled");
+                        bool ok = WriteFiles(files, dir, &changed, &removed);
+                        job.progress = 1.0f;
+                        if (!ok) return fmt::format("Could not write to {}", dir);
+                        std::string status = fmt::format("Updated {} of {} files in {}", changed, files.size(), dir);
+                        if (removed) status += fmt::format(", removed {} no longer generated", removed);
+                        return status;
+                    });
+                    exportstatus.clear();
+                }
+                if (!exportstatus.empty()) ImGui::TextDisabled("%s", exportstatus.c_str());
+                ImGui::EndMenu();
+            }
+            if (ImGui::BeginMenu("Hot reload"))
+            {
+                ImGui::InputText("Directory", &hotdir);
+                ImGui::InputText("ImGui Dir", &imguidir);
+                ImGui::SameLine();
+                utils::HelpMarker("Dear ImGui sources (imgui.h, backends/) the module and the host are built with");
+                if (ImGui::MenuItem("Enabled", NULL, &hotreload)) hotstale = hotreload;
+                ImGui::SameLine();
+                utils::HelpMarker("Write the design as a module project (split sources in a state struct, a host and a "
+                                  "Makefile) and run make on every change. The host (make host, then ./host in the "
+                                  "directory) loads each new libui.so between frames and keeps the widget state while "
+                                  "the state struct is unchanged");
+                if (ImGui::MenuItem("Rebuild", NULL, false, hotreload)) hotstale = true;
+                if (!hotstatus.empty()) ImGui::TextDisabled("%s", hotstatus.c_str());
+                ImGui::EndMenu();
+            }
+            if (ImGui::BeginMenu("Design file"))
+            {
+                ImGui::InputText("File", &designpath);
+                if (ImGui::MenuItem("Open", NULL, false, !loadjob.valid()))
+                {
+                    reloadpending = true;
+                    reloadlive    = false;
+                    if (livereload) designwatch.watch(designpath);
+                }
+                if (ImGui::MenuItem("Save", NULL, false, !savejob.valid() && !loadjob.valid()))
+                {
+                    bw.publish(); // edits made earlier in this frame
+                    std::shared_ptr<const DesignSnapshot> snap = bw.snapshot();
+                    std::string path = designpath;
+                    savejob = jobs.submit<DesignIO>("Saving", [snap, path](JobState &)
+                    {
+                        return StoreDesign(path, *snap);
+                    });
+                }
+                if (ImGui::MenuItem("Live reload", NULL, &livereload))
+                {
+                    if (livereload) designwatch.watch(designpath);
+                    else            designwatch.stop();
+                }
+                ImGui::SameLine();
+                utils::HelpMarker("Watch the design file and apply changes made by other programs or scripts as they "
+                                  "are saved. Only objects the file changed are replaced, local edits to the others and the selection are kept");
+                if (!designstatus.empty()) ImGui::TextDisabled("%s", designstatus.c_str());
+                ImGui::EndMenu();
+            }
             #endif
 
             if (ImGui::MenuItem("Exit"))
@@ -45,17 +505,90 @@ void ImStudio::GUI::ShowMenubar()
             }
             if (ImGui::BeginMenu("Behavior"))
             {
-                ImGui::MenuItem("Static Mode", NULL, &bw.staticlayout);
+                if (ImGui::MenuItem("Static Mode", NULL, &bw.staticlayout)) bw.events.publish(nullptr, nullptr);
                 ImGui::SameLine();
                 utils::HelpMarker("Toggle between static/linear layout and fixed/manual layout");
 
                 ImGui::EndMenu();
             }
+            if (ImGui::BeginMenu("Generator"))
+            {
+                bool regen = false; // the output and the hot reload module both follow the options
+                regen |= ImGui::MenuItem("Layout Tables", NULL, &genopts.tables);
+                ImGui::SameLine();
+                utils::HelpMarker("Emit constexpr widget records and a single render loop instead of per-widget statements");
+                regen |= ImGui::MenuItem("Precomputed IDs", NULL, &genopts.hashedids);
+                ImGui::SameLine();
+                utils::HelpMarker("Hash hidden (\"##\") labels at generation time and push the IDs with "
+                                  "PushOverrideID, so those widgets do no per-frame label hashing (needs imgui_internal.h)");
+                regen |= ImGui::MenuItem("State Struct", NULL, &genopts.statestruct);
+                ImGui::SameLine();
+                utils::HelpMarker("Gather all widget state in one WindowState struct and emit a DrawWindow(WindowState&) "
+                                  "function instead of function-static variables");
+                regen |= ImGui::MenuItem("Split Files", NULL, &genopts.split);
+                ImGui::SameLine();
+                utils::HelpMarker("Emit a small header, a window source and one source per container or per N loose "
+                                  "widgets, so the UI compiles in parallel and edits only rebuild their own file "
+                                  "(File > Export files)");
+                regen |= ImGui::MenuItem("Optimize", NULL, &genopts.optimize);
+                ImGui::SameLine();
+                utils::HelpMarker("Run peephole passes over the generated code: merge adjacent equal item width scopes, "
+                                  "drop redundant cursor moves and share identical items arrays. The savings are "
+                                  "reported at the top of the output");
+                regen |= ImGui::MenuItem("String Table", NULL, &genopts.stringtable);
+                ImGui::SameLine();
+                utils::HelpMarker("Collect labels and combo/listbox items into one deduplicated strings[] table at the "
+                                  "top of the output and refer to them by index");
+                ImGui::SetNextItemWidth(ImGui::GetFontSize() * 10);
+                regen |= ImGui::InputText("Data Struct", &genopts.datastruct);
+                ImGui::SameLine();
+                utils::HelpMarker("Type of your application data. Widgets with a Bind field edit that field of it "
+                                  "directly (data.field), and DrawWindow() takes it as a parameter. Text inputs "
+                                  "bind to char arrays");
+                ImGui::SetNextItemWidth(ImGui::GetFontSize() * 10);
+                regen |= ImGui::InputText("Data Header", &genopts.datainclude);
+                ImGui::SameLine();
+                utils::HelpMarker("Header declaring the data struct, included by the generated code. Left empty, "
+                                  "the struct is only declared");
+                regen |= ImGui::MenuItem("User Regions", NULL, &genopts.userregions);
+                ImGui::SameLine();
+                utils::HelpMarker("Emit \"USER CODE BEGIN/END\" comments after every widget; on export, code written "
+                                  "between them is kept and unchanged files are not rewritten");
+                if (genopts.split)
+                {
+                    ImGui::SetNextItemWidth(ImGui::GetFontSize() * 6);
+                    regen |= ImGui::DragInt("Widgets per file", &genopts.splitsize, 1.0f, 0, 4096);
+                    regen |= ImGui::MenuItem("CMake Snippet", NULL, &genopts.cmakesnippet);
+                }
+                if (ImGui::BeginMenu("Templates"))
+                {
+                    ImGui::InputText("File", &templatepath);
+                    if (ImGui::MenuItem("Load"))
+                    {
+                        usetemplates   = templates.load(templatepath);
+                        templatestatus = usetemplates ? fmt::format("{} sections", templates.names.size()) : templates.error;
+                        regen          = true;
+                    }
+                    regen |= ImGui::MenuItem("Use Templates", NULL, &usetemplates, !templates.names.empty());
+                    ImGui::SameLine();
+                    utils::HelpMarker("Sections \"@@ <widget type>\" (or child, endchild, prologue, epilogue) followed by "
+                                      "the code to emit; $(field) inserts id, label, value_s, pos.x, size.x, width, cursor... "
+                                      "Kinds without a section use the built-in output");
+                    if (!templatestatus.empty()) ImGui::TextDisabled("%s", templatestatus.c_str());
+                    genopts.templates = usetemplates ? &templates : nullptr;
+                    ImGui::EndMenu();
+                }
+                outputstale |= regen;
+                hotstale    |= regen;
+
+                ImGui::EndMenu();
+            }
             if (ImGui::MenuItem("Reset"))
             {
                 if (bw.current_child)
                     bw.current_child = nullptr;
                 bw.objects.clear();
+                bw.events.publish(nullptr, nullptr);
             }
 
             ImGui::EndMenu();
@@ -69,6 +602,7 @@ void ImStudio::GUI::ShowMenubar()
             ImGui::MenuItem("Metrics", NULL, &child_metrics);
             ImGui::MenuItem("Stack Tool", NULL, &child_stack);
             ImGui::MenuItem("Color Export", NULL, &child_color);
+            ImGui::MenuItem("Minimap", NULL, &child_minimap);
             ImGui::EndMenu();
         }
 
@@ -79,6 +613,9 @@ void ImStudio::GUI::ShowMenubar()
             ImGui::EndMenu();
         }
 
+        for (const std::shared_ptr<JobState> &job : jobs.active())
+            ShowJob(*job);
+
         ImGui::EndMenuBar();
     }
 
@@ -322,6 +859,26 @@ void ImStudio::GUI::ShowSidebar()
             if(bw.current_child) bw.current_child->child.open = false;
         }
 
+        if ((bw.current_child) && (bw.current_child->child.open))
+        {
+            ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.000f, 1.000f, 0.110f, 1.000f));
+            ImGui::Button("TreeNode"); // does nothing
+            ImGui::PopStyleColor(1);
+        }
+        else if (ImGui::Button("TreeNode"))
+        {
+            bw.create("treenode");
+        }
+        ImGui::SameLine(); utils::HelpMarker
+        ("Opens like BeginChild: the widgets added next go under the node until TreePop. Source: a LazyTree "
+         "in your code (the generated code declares it), whose children are only asked for while their parent "
+         "is expanded and drawn through a clipper, so the tree can have millions of nodes.");
+
+        if (ImGui::Button("TreePop"))
+        {
+            if(bw.current_child) bw.current_child->child.open = false;
+        }
+
         ImGui::BeginDisabled(true);
         if (ImGui::Button("BeginGroup"))
         {
@@ -351,9 +908,39 @@ void ImStudio::GUI::ShowSidebar()
         {
             bw.create("progressbar");
         }
+
+        if (ImGui::Button("Plot Lines"))
+        {
+            bw.create("plotlines");
+        }
+        ImGui::SameLine(); utils::HelpMarker
+        ("Source: a float container with data() and size() in your code, e.g. a std::vector<float>. "
+         "Left empty, the widget gets a vector of its own. Long series are reduced to min/max per pixel "
+         "column before they are drawn.");
+
+        if (ImGui::Button("Plot Histogram"))
+        {
+            bw.create("plothistogram");
+        }
+
+        if (ImGui::Button("Image"))
+        {
+            bw.create("image");
+        }
+        ImGui::SameLine(); utils::HelpMarker
+        ("Source: the image file. The generated code packs every image of the window into atlas pages and "
+         "lists where each source goes, so the images share one texture and one draw call.");
+
+        if (ImGui::Button("Text Log"))
+        {
+            bw.create("textlog");
+        }
+        ImGui::SameLine(); utils::HelpMarker
+        ("Source: a TextLog in your code (the generated code declares it). Lines are added with append(); "
+         "only the lines in view are drawn, so the log can hold megabytes.");
         ImGui::Separator();
 
-        ImGui::Checkbox("Static Mode", &bw.staticlayout);
+        if (ImGui::Checkbox("Static Mode", &bw.staticlayout)) bw.events.publish(nullptr, nullptr);
 
         if ((ImGui::GetIO().KeyAlt) && (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_F4))))
         {
@@ -445,6 +1032,15 @@ void ImStudio::GUI::ShowProperties()
                         }
                     }
                 }
+                if (jumpid != 0) // link from the ID collision list
+                {
+                    for (size_t n = 0; n < idarr.size(); n++)
+                    {
+                        if (idarr[n] == jumpid) selectproparray = (int)n;
+                    }
+                    jumpid = 0;
+                }
+                if (selectproparray >= (int)idarr.size()) selectproparray = 0; // removed by a reload
                 //!SECTION CREATE PROPARRAY
                 ImGui::Combo("Object", &selectproparray,  items.data(), items.size());
 
@@ -458,809 +1054,77 @@ void ImStudio::GUI::ShowProperties()
                     selectid  = selectobj->id;
                 }
 
-                /////////PROP BUFFER/////////
-                static std::string prop_text1   = "change me";
-                static std::string prop_text2   = "";
-                /////////////////////////////
-
-                if (selectobj->id != previd)
-                {
-                    //reset prop buffer so text input value is not transferred from object to object
-                    prop_text1 = "change me";
-                    prop_text2 = "##";
-                    //bw.resetpropbuffer();
-                }
-
-                if (selectobj->type == "button")
+                if (selectobj->type == "child")
                 {
-                    if (selectobj->propinit) prop_text1 = selectobj->value_s; // run after first time
-
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-
-                    ImGui::InputText("Value", &prop_text1);
-                    selectobj->value_s = prop_text1;
+                    if (bw.getobj(selectobj->id)->child.open) ImGui::Text("OPEN");
+                    else ImGui::Text("CLOSED");
                     ImGui::NewLine();
 
-                    ImGui::Checkbox("Center Horizontally", &selectobj->center_h);
-
-                    if (selectobj->center_h) ImGui::BeginDisabled(true);
-                    ImGui::InputFloat("Position X", &selectobj->pos.x, 1.0f, 10.0f, "%.3f");
-                    if (selectobj->center_h) ImGui::EndDisabled();
-
-                    ImGui::InputFloat("Position Y", &selectobj->pos.y, 1.0f, 10.0f, "%.3f");
-
-                    ImGui::Checkbox("Drag Locked", &selectobj->locked);
+                    bool edited = ImGui::Checkbox("Border", &bw.getobj(selectobj->id)->child.border);
                     ImGui::NewLine();
 
-                    ImGui::Checkbox("Auto Resize", &selectobj->autoresize);
-                    
-                    if (selectobj->autoresize) ImGui::BeginDisabled(true);
-                    ImGui::InputFloat("Size X", &selectobj->size.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Size Y", &selectobj->size.y, 1.0f, 10.0f, "%.3f");
-                    if (selectobj->autoresize) ImGui::EndDisabled();
+                    ImGui::InputFloat("Min X", &bw.getobj(selectobj->id)->child.grab1.x, 1.0f, 10.0f, "%.3f");
+                    ImGui::InputFloat("Min Y", &bw.getobj(selectobj->id)->child.grab1.y, 1.0f, 10.0f, "%.3f");
+                    ImGui::InputFloat("Max X", &bw.getobj(selectobj->id)->child.grab2.x, 1.0f, 10.0f, "%.3f");
+                    ImGui::InputFloat("Max Y", &bw.getobj(selectobj->id)->child.grab2.y, 1.0f, 10.0f, "%.3f");
+                    ImGui::Checkbox("Drag Locked", &bw.getobj(selectobj->id)->child.locked);
+                    if (edited) bw.events.publish(selectobj, nullptr); // grabs are picked up by drawall
 
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
+                    if (ImGui::Button("Open"))
                     {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
+                        bw.current_child             = bw.getobj(selectobj->id);
+                        bw.current_child->child.open = true;
                     }
-                }
-
-                if (selectobj->type == "checkbox")
-                {
-                    const char *items[] = {"False", "True"};
-                    static int  cur     = 0;
-                    if (selectobj->propinit)
+                    if (ImGui::Button("Close"))
                     {
-                        prop_text2 = selectobj->label;
-                        cur = selectobj->value_b;
+                        bw.current_child             = bw.getobj(selectobj->id);
+                        bw.current_child->child.open = false;
                     }
-
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-
-                    ImGui::InputText("Label", &prop_text2);
-                    selectobj->label   = prop_text2;
-                    ImGui::Combo("Value", &cur, items, IM_ARRAYSIZE(items));
-                    if (cur == 0) selectobj->value_b = false;
-                    else selectobj->value_b = true;
-                    
                     ImGui::NewLine();
 
-                    ImGui::Checkbox("Center Horizontally", &selectobj->center_h);
-                    ImGui::InputFloat("Position X", &selectobj->pos.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Position Y", &selectobj->pos.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::Checkbox("Drag Locked", &selectobj->locked);
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
+                    if ((ImGui::Button("Delete")) ||
+                        (!ImGui::GetIO().WantTextInput && ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
                     {
+                        bw.current_child             = bw.getobj(selectobj->id);
+                        bw.current_child->child.open = false;
+                        bw.current_child = nullptr;
                         selectobj->del();
                         if (selectproparray != 0) selectproparray -= 1;
                     }
                 }
-
-                if (selectobj->type == "radio")
+                else
                 {
-                    const char *items[] = {"False", "True"};
-                    static int  cur     = 0;
-                    if (selectobj->propinit)
-                    {
-                        prop_text2 = selectobj->label;
-                        cur = selectobj->value_b;
-                    }
-
                     //Stats
                     if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
                     else ImGui::Text("Child Widget: False");
                     ImGui::NewLine();
 
-                    ImGui::InputText("Label", &prop_text2);
-                    selectobj->label   = prop_text2;
-                    ImGui::Combo("Value", &cur, items, IM_ARRAYSIZE(items));
-                    if (cur == 0) selectobj->value_b = false;
-                    else selectobj->value_b = true;
-                    
-                    ImGui::NewLine();
-
-                    ImGui::Checkbox("Center Horizontally", &selectobj->center_h);
-                    ImGui::InputFloat("Position X", &selectobj->pos.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Position Y", &selectobj->pos.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::Checkbox("Drag Locked", &selectobj->locked);
+                    std::vector<BaseObject *> targets(1, selectobj);
+                    EditProperties(targets, &bw.events);
 
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-                if (selectobj->type == "text")
-                {
-                    if (selectobj->propinit)
+                    if ((selectobj->type == "treenode") && (!selectobj->ischildwidget))
                     {
-                        prop_text1 = selectobj->value_s;
+                        ImGui::NewLine();
+                        if (ImGui::Button("Open"))
+                        {
+                            bw.current_child             = bw.getobj(selectobj->id);
+                            bw.current_child->child.open = true;
+                        }
+                        ImGui::SameLine();
+                        if (ImGui::Button("Close"))
+                        {
+                            bw.current_child             = bw.getobj(selectobj->id);
+                            bw.current_child->child.open = false;
+                        }
+                        ImGui::SameLine();
+                        if (bw.getobj(selectobj->id)->child.open) ImGui::Text("OPEN");
+                        else ImGui::Text("CLOSED");
                     }
 
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-
-                    ImGui::InputText("Value", &prop_text1);
-                    ImGui::NewLine();
-                    ImGui::Checkbox("Center Horizontally", &selectobj->center_h);
-                    ImGui::InputFloat("Position X", &selectobj->pos.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Position Y", &selectobj->pos.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::Checkbox("Drag Locked", &selectobj->locked);
-                    selectobj->value_s = prop_text1;
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-                if (selectobj->type == "bullet")
-                {
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-
-                    ImGui::Checkbox("Center Horizontally", &selectobj->center_h);
-                    ImGui::InputFloat("Position X", &selectobj->pos.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Position Y", &selectobj->pos.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::Checkbox("Drag Locked", &selectobj->locked);
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-                if (selectobj->type == "arrow")
-                {
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-                    
-                    ImGui::Checkbox("Center Horizontally", &selectobj->center_h);
-                    ImGui::InputFloat("Position X", &selectobj->pos.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Position Y", &selectobj->pos.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::Checkbox("Drag Locked", &selectobj->locked);
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-                if (selectobj->type == "combo")
-                {
-                    if (selectobj->propinit) prop_text2 = selectobj->label;
-
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-
-                    ImGui::InputText("Label", &prop_text2);
-                    selectobj->label = prop_text2;
-                    ImGui::NewLine();
-
-                    ImGui::InputFloat("Width", &selectobj->width, 1.0f, 10.0f, "%.3f");
-                    ImGui::NewLine();
-
-                    ImGui::Checkbox("Center Horizontally", &selectobj->center_h);
-                    ImGui::InputFloat("Position X", &selectobj->pos.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Position Y", &selectobj->pos.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::Checkbox("Drag Locked", &selectobj->locked);
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-                if (selectobj->type == "listbox")
-                {
-                    if (selectobj->propinit) prop_text2 = selectobj->label;
-
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-
-                    ImGui::InputText("Label", &prop_text2);
-                    selectobj->label = prop_text2;
-                    ImGui::NewLine();
-
-                    ImGui::InputFloat("Width", &selectobj->width, 1.0f, 10.0f, "%.3f");
-                    ImGui::NewLine();
-
-                    ImGui::Checkbox("Center Horizontally", &selectobj->center_h);
-                    ImGui::InputFloat("Position X", &selectobj->pos.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Position Y", &selectobj->pos.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::Checkbox("Drag Locked", &selectobj->locked);
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-                if (selectobj->type == "textinput")
-                {
-                    if (selectobj->propinit)
-                    {
-                        prop_text1 = selectobj->value_s;
-                        prop_text2 = selectobj->label;
-                    }
-
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-
-                    ImGui::InputText("Label", &prop_text2);
-                    ImGui::InputText("Value", &prop_text1);
-                    ImGui::NewLine();
-                    ImGui::InputFloat("Width", &selectobj->width, 1.0f, 10.0f, "%.3f");
-                    ImGui::NewLine();
-                    ImGui::Checkbox("Center Horizontally", &selectobj->center_h);
-                    ImGui::InputFloat("Position X", &selectobj->pos.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Position Y", &selectobj->pos.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::Checkbox("Drag Locked", &selectobj->locked);
-                    selectobj->label   = prop_text2;
-                    selectobj->value_s = prop_text1;
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-                if (selectobj->type == "inputint")
-                {
-                    if (selectobj->propinit)
-                    {
-                        prop_text2 = selectobj->label;
-                    }
-
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-
-                    ImGui::InputText("Label", &prop_text2);
-                    ImGui::NewLine();
-                    ImGui::InputFloat("Width", &selectobj->width, 1.0f, 10.0f, "%.3f");
-                    ImGui::NewLine();
-                    ImGui::Checkbox("Center Horizontally", &selectobj->center_h);
-                    ImGui::InputFloat("Position X", &selectobj->pos.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Position Y", &selectobj->pos.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::Checkbox("Drag Locked", &selectobj->locked);
-                    selectobj->label = prop_text2;
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-                if (selectobj->type == "inputfloat")
-                {
-                    if (selectobj->propinit)
-                    {
-                        prop_text2 = selectobj->label;
-                    }
-
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-
-                    ImGui::InputText("Label", &prop_text2);
-                    ImGui::NewLine();
-                    ImGui::InputFloat("Width", &selectobj->width, 1.0f, 10.0f, "%.3f");
-                    ImGui::NewLine();
-                    ImGui::Checkbox("Center Horizontally", &selectobj->center_h);
-                    ImGui::InputFloat("Position X", &selectobj->pos.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Position Y", &selectobj->pos.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::Checkbox("Drag Locked", &selectobj->locked);
-                    selectobj->label = prop_text2;
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-                if (selectobj->type == "inputdouble")
-                {
-                    if (selectobj->propinit)
-                    {
-                        prop_text2 = selectobj->label;
-                    }
-
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-
-                    ImGui::InputText("Label", &prop_text2);
-                    ImGui::NewLine();
-                    ImGui::InputFloat("Width", &selectobj->width, 1.0f, 10.0f, "%.3f");
-                    ImGui::NewLine();
-                    ImGui::Checkbox("Center Horizontally", &selectobj->center_h);
-                    ImGui::InputFloat("Position X", &selectobj->pos.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Position Y", &selectobj->pos.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::Checkbox("Drag Locked", &selectobj->locked);
-                    selectobj->label = prop_text2;
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-                if (selectobj->type == "inputscientific")
-                {
-                    if (selectobj->propinit)
-                    {
-                        prop_text2 = selectobj->label;
-                    }
-
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-
-                    ImGui::InputText("Label", &prop_text2);
-                    ImGui::NewLine();
-                    ImGui::InputFloat("Width", &selectobj->width, 1.0f, 10.0f, "%.3f");
-                    ImGui::NewLine();
-                    ImGui::Checkbox("Center Horizontally", &selectobj->center_h);
-                    ImGui::InputFloat("Position X", &selectobj->pos.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Position Y", &selectobj->pos.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::Checkbox("Drag Locked", &selectobj->locked);
-                    selectobj->label = prop_text2;
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-                if (selectobj->type == "inputfloat3")
-                {
-                    if (selectobj->propinit)
-                    {
-                        prop_text2 = selectobj->label;
-                    }
-
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-
-                    ImGui::InputText("Label", &prop_text2);
-                    ImGui::NewLine();
-                    ImGui::InputFloat("Width", &selectobj->width, 1.0f, 10.0f, "%.3f");
-                    ImGui::NewLine();
-                    ImGui::Checkbox("Center Horizontally", &selectobj->center_h);
-                    ImGui::InputFloat("Position X", &selectobj->pos.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Position Y", &selectobj->pos.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::Checkbox("Drag Locked", &selectobj->locked);
-                    selectobj->label = prop_text2;
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-                if (selectobj->type == "dragint")
-                {
-                    if (selectobj->propinit)
-                    {
-                        prop_text2 = selectobj->label;
-                    }
-
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-
-                    ImGui::InputText("Label", &prop_text2);
-                    ImGui::NewLine();
-                    ImGui::InputFloat("Width", &selectobj->width, 1.0f, 10.0f, "%.3f");
-                    ImGui::NewLine();
-                    ImGui::Checkbox("Center Horizontally", &selectobj->center_h);
-                    ImGui::InputFloat("Position X", &selectobj->pos.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Position Y", &selectobj->pos.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::Checkbox("Drag Locked", &selectobj->locked);
-                    selectobj->label = prop_text2;
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-                if (selectobj->type == "dragint100")
-                {
-                    if (selectobj->propinit)
-                    {
-                        prop_text2 = selectobj->label;
-                    }
-
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-
-                    ImGui::InputText("Label", &prop_text2);
-                    ImGui::NewLine();
-                    ImGui::InputFloat("Width", &selectobj->width, 1.0f, 10.0f, "%.3f");
-                    ImGui::NewLine();
-                    ImGui::Checkbox("Center Horizontally", &selectobj->center_h);
-                    ImGui::InputFloat("Position X", &selectobj->pos.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Position Y", &selectobj->pos.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::Checkbox("Drag Locked", &selectobj->locked);
-                    selectobj->label = prop_text2;
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-                if (selectobj->type == "dragfloat")
-                {
-                    if (selectobj->propinit)
-                    {
-                        prop_text2 = selectobj->label;
-                    }
-
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-
-                    ImGui::InputText("Label", &prop_text2);
-                    ImGui::NewLine();
-                    ImGui::InputFloat("Width", &selectobj->width, 1.0f, 10.0f, "%.3f");
-                    ImGui::NewLine();
-                    ImGui::Checkbox("Center Horizontally", &selectobj->center_h);
-                    ImGui::InputFloat("Position X", &selectobj->pos.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Position Y", &selectobj->pos.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::Checkbox("Drag Locked", &selectobj->locked);
-                    selectobj->label = prop_text2;
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-                if (selectobj->type == "dragfloatsmall")
-                {
-                    if (selectobj->propinit)
-                    {
-                        prop_text2 = selectobj->label;
-                    }
-
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-
-                    ImGui::InputText("Label", &prop_text2);
-                    ImGui::NewLine();
-                    ImGui::InputFloat("Width", &selectobj->width, 1.0f, 10.0f, "%.3f");
-                    ImGui::NewLine();
-                    ImGui::Checkbox("Center Horizontally", &selectobj->center_h);
-                    ImGui::InputFloat("Position X", &selectobj->pos.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Position Y", &selectobj->pos.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::Checkbox("Drag Locked", &selectobj->locked);
-                    selectobj->label = prop_text2;
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-                if (selectobj->type == "sliderint")
-                {
-                    if (selectobj->propinit)
-                    {
-                        prop_text2 = selectobj->label;
-                    }
-
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-
-                    ImGui::InputText("Label", &prop_text2);
-                    ImGui::NewLine();
-                    ImGui::InputFloat("Width", &selectobj->width, 1.0f, 10.0f, "%.3f");
-                    ImGui::NewLine();
-                    ImGui::Checkbox("Center Horizontally", &selectobj->center_h);
-                    ImGui::InputFloat("Position X", &selectobj->pos.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Position Y", &selectobj->pos.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::Checkbox("Drag Locked", &selectobj->locked);
-                    selectobj->label = prop_text2;
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-                if (selectobj->type == "sliderfloat")
-                {
-                    if (selectobj->propinit)
-                    {
-                        prop_text2 = selectobj->label;
-                    }
-
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-
-                    ImGui::InputText("Label", &prop_text2);
-                    ImGui::NewLine();
-                    ImGui::InputFloat("Width", &selectobj->width, 1.0f, 10.0f, "%.3f");
-                    ImGui::NewLine();
-                    ImGui::Checkbox("Center Horizontally", &selectobj->center_h);
-                    ImGui::InputFloat("Position X", &selectobj->pos.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Position Y", &selectobj->pos.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::Checkbox("Drag Locked", &selectobj->locked);
-                    selectobj->label = prop_text2;
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-                if (selectobj->type == "sliderfloatlog")
-                {
-                    if (selectobj->propinit)
-                    {
-                        prop_text2 = selectobj->label;
-                    }
-
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-
-                    ImGui::InputText("Label", &prop_text2);
-                    ImGui::NewLine();
-                    ImGui::InputFloat("Width", &selectobj->width, 1.0f, 10.0f, "%.3f");
-                    ImGui::NewLine();
-                    ImGui::Checkbox("Center Horizontally", &selectobj->center_h);
-                    ImGui::InputFloat("Position X", &selectobj->pos.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Position Y", &selectobj->pos.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::Checkbox("Drag Locked", &selectobj->locked);
-                    selectobj->label = prop_text2;
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-                if (selectobj->type == "sliderangle")
-                {
-                    if (selectobj->propinit)
-                    {
-                        prop_text2 = selectobj->label;
-                    }
-
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-
-                    ImGui::InputText("Label", &prop_text2);
-                    ImGui::NewLine();
-                    ImGui::InputFloat("Width", &selectobj->width, 1.0f, 10.0f, "%.3f");
-                    ImGui::NewLine();
-                    ImGui::Checkbox("Center Horizontally", &selectobj->center_h);
-                    ImGui::InputFloat("Position X", &selectobj->pos.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Position Y", &selectobj->pos.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::Checkbox("Drag Locked", &selectobj->locked);
-                    selectobj->label = prop_text2;
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-                if (selectobj->type == "color1")
-                {
-                    if (selectobj->propinit)
-                    {
-                        prop_text2 = selectobj->label;
-                    }
-
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-
-                    ImGui::InputText("Label", &prop_text2);
-                    ImGui::NewLine();
-                    ImGui::Checkbox("Center Horizontally", &selectobj->center_h);
-                    ImGui::InputFloat("Position X", &selectobj->pos.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Position Y", &selectobj->pos.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::Checkbox("Drag Locked", &selectobj->locked);
-                    selectobj->label = prop_text2;
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-                if (selectobj->type == "color2")
-                {
-                    if (selectobj->propinit)
-                    {
-                        prop_text2 = selectobj->label;
-                    }
-
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-
-                    ImGui::InputText("Label", &prop_text2);
-                    ImGui::NewLine();
-                    ImGui::InputFloat("Width", &selectobj->width, 1.0f, 10.0f, "%.3f");
-                    ImGui::NewLine();
-                    ImGui::Checkbox("Center Horizontally", &selectobj->center_h);
-                    ImGui::InputFloat("Position X", &selectobj->pos.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Position Y", &selectobj->pos.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::Checkbox("Drag Locked", &selectobj->locked);
-                    selectobj->label = prop_text2;
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-                if (selectobj->type == "color3")
-                {
-                    if (selectobj->propinit)
-                    {
-                        prop_text2 = selectobj->label;
-                    }
-
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-
-                    ImGui::InputText("Label", &prop_text2);
-                    ImGui::NewLine();
-                    ImGui::InputFloat("Width", &selectobj->width, 1.0f, 10.0f, "%.3f");
-                    ImGui::NewLine();
-                    ImGui::Checkbox("Center Horizontally", &selectobj->center_h);
-                    ImGui::InputFloat("Position X", &selectobj->pos.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Position Y", &selectobj->pos.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::Checkbox("Drag Locked", &selectobj->locked);
-                    selectobj->label = prop_text2;
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-
-                if (selectobj->type == "child")
-                {
-                    if (bw.getobj(selectobj->id)->child.open) ImGui::Text("OPEN");
-                    else ImGui::Text("CLOSED");
-                    ImGui::NewLine();
-
-                    ImGui::Checkbox("Border", &bw.getobj(selectobj->id)->child.border);
-                    ImGui::NewLine();
-
-                    ImGui::InputFloat("Min X", &bw.getobj(selectobj->id)->child.grab1.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Min Y", &bw.getobj(selectobj->id)->child.grab1.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Max X", &bw.getobj(selectobj->id)->child.grab2.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Max Y", &bw.getobj(selectobj->id)->child.grab2.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::Checkbox("Drag Locked", &bw.getobj(selectobj->id)->child.locked);
-
-                    if (ImGui::Button("Open"))
-                    {
-                        bw.current_child             = bw.getobj(selectobj->id);
-                        bw.current_child->child.open = true;
-                    }
-                    if (ImGui::Button("Close"))
-                    {
-                        bw.current_child             = bw.getobj(selectobj->id);
-                        bw.current_child->child.open = false;
-                    }
-                    ImGui::NewLine();
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        bw.current_child             = bw.getobj(selectobj->id);
-                        bw.current_child->child.open = false;
-                        bw.current_child = nullptr;
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-                if (selectobj->type == "sameline")
-                {
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-                    
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-                if (selectobj->type == "newline")
-                {
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-                if (selectobj->type == "separator")
-                {
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
-                    {
-                        selectobj->del();
-                        if (selectproparray != 0) selectproparray -= 1;
-                    }
-                }
-                if (selectobj->type == "progressbar")
-                {
-                    //Stats
-                    if (selectobj->ischildwidget) ImGui::Text("Child Widget: True");
-                    else ImGui::Text("Child Widget: False");
-                    ImGui::NewLine();
-                    
-                    ImGui::Checkbox("Center Horizontally", &selectobj->center_h);
-                    ImGui::InputFloat("Position X", &selectobj->pos.x, 1.0f, 10.0f, "%.3f");
-                    ImGui::InputFloat("Position Y", &selectobj->pos.y, 1.0f, 10.0f, "%.3f");
-                    ImGui::Checkbox("Drag Locked", &selectobj->locked);
-
-                    if ((ImGui::Button("Delete")) || (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
+                    if ((ImGui::Button("Delete")) ||
+                        (!ImGui::GetIO().WantTextInput && ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete))))
                     {
+                        if (bw.current_child == selectobj) bw.current_child = nullptr;
                         selectobj->del();
                         if (selectproparray != 0) selectproparray -= 1;
                     }
@@ -1284,21 +1148,58 @@ void ImStudio::GUI::ShowViewport(int gen_rand)
     /// content-viewport
     {
         utils::DrawGrid();
-        
+
+        ShowDocuments();
         ImGui::Text("Buffer Window: %gx%g", bw.size.x, bw.size.y);
         ImGui::SameLine();
         utils::TextCentered("Make sure to lock widgets before interacting with them.", 1);
         ImGui::Text("Objects: %d", static_cast<int>(bw.objects.size()));
         ImGui::Text("Objects (all): %d", allvecsize);
-        if (!bw.objects.empty()) ImGui::Text("Selected: %s", selectobj->identifier.c_str());
+        if (!bw.objects.empty() && selectobj) ImGui::Text("Selected: %s", selectobj->identifier.c_str());
         ImGui::Text("Performance: %.1f FPS", ImGui::GetIO().Framerate);
-        
+
+        if (!idcheck.collisions.empty() &&
+            ImGui::TreeNode("idcollisions", "ID collisions: %d", static_cast<int>(idcheck.collisions.size())))
+        {
+            for (const IdCollision &c : idcheck.collisions)
+            {
+                ImGui::Text("0x%08X \"%s\":", c.id, c.label.c_str());
+                for (size_t n = 0; (n < c.entries.size()) && (n < 8); n++)
+                {
+                    const IdEntry &e = idcheck.entries[c.entries[n]];
+                    ImGui::SameLine();
+                    ImGui::PushID(static_cast<int>(c.entries[n]));
+                    if (ImGui::SmallButton(e.identifier.c_str())) jumpid = e.object;
+                    ImGui::PopID();
+                }
+                if (c.entries.size() > 8)
+                {
+                    ImGui::SameLine();
+                    ImGui::TextDisabled("+%d more", static_cast<int>(c.entries.size() - 8));
+                }
+            }
+            ImGui::TreePop();
+        }
+
         bw.drawall(&selectid, gen_rand);
     }
 
     ImGui::End();
 }
 
+// Overview of the whole design; clicking or dragging in it centers the buffer window there
+void ImStudio::GUI::ShowMinimap()
+{
+    ImGui::SetNextWindowSize(ImVec2(340, 300), ImGuiCond_FirstUseEver);
+    if (ImGui::Begin("Minimap", &child_minimap))
+    {
+        ImVec2 target;
+        if (minimap.draw(bw, ImGui::GetContentRegionAvail(), &target))
+            bw.scrollto = ImVec2(ImMax(target.x - bw.size.x * 0.5f, 0.0f), ImMax(target.y - bw.size.y * 0.5f, 0.0f));
+    }
+    ImGui::End();
+}
+
 // ANCHOR OUTPUTWKSP.DEFINITION
 void ImStudio::GUI::ShowOutputWorkspace()
 {
@@ -1310,12 +1211,12 @@ void ImStudio::GUI::ShowOutputWorkspace()
 #ifdef __EMSCRIPTEN__
         if(ImGui::Button("Copy")){
             ImGui::LogToClipboard();
-            ImGui::LogText(output.c_str());
-            ImGui::LogFinish();
+            ImGui::LogText("%s", output.c_str());
+            ImGui::LogFinish(); // reaches the browser through JsClipboard_InstallExportHook()
         };
-        JsClipboard_SetClipboardText(ImGui::GetClipboardText());
 #endif
-        ImStudio::GenerateCode(&output, &bw);
+        ImGui::InputTextMultiline("##source", &output,
+                                  ImVec2(-FLT_MIN, ImGui::GetTextLineHeight() * 64), ImGuiInputTextFlags_ReadOnly);
     }
     ImGui::End();
 }
@@ -3,13 +3,57 @@
 #include "../includes.h"
 #include "object.h"
 #include "buffer.h"
+#include "generator.h"
+#include "jobs.h"
+#include "designfile.h"
+#include "hotreload.h"
+#include "minimap.h"
 
 namespace ImStudio
 {
 
+    // A buffer window while another one is focused: its design and the per-window editor state parked with it.
+    // The focused window's state lives in GUI (bw, idcheck, ...) and is swapped with its slot on focus changes.
+    struct DesignWindow
+    {
+        std::string             name                       = {};                   // Thumbnail caption
+        BufferWindow            bw;
+        IdCheck                 idcheck                    = {};                   //--
+        std::string             output                     = {};                   //  | Swapped with GUI
+        int                     selectid                   = 0;                    //  |
+        int                     selectproparray            = 0;                    //--
+        std::vector<ImRect>     thumbnail                  = {};                   // Occupied cells in [0,1], from Park
+    };
+
+    // One tab: a set of buffer windows and the design file they are saved to
+    struct Document
+    {
+        std::string             name                       = {};                   // Tab label
+        std::string             designpath                 = {};                   //-- Swapped with GUI
+        std::shared_ptr<const DesignBase> designbase       = nullptr;              //--
+        std::vector<std::unique_ptr<DesignWindow>> windows = {};                   // Slot of the focused one is stale
+        int                     focused                    = 0;                    // Window shown in the viewport
+    };
+
+    struct DesignOutput
+    {
+        bool                    generated                  = false;                // output is set (else lint only)
+        std::string             output                     = {};                   // Generated code
+    };
+
     struct GUI
     {
         bool                    state                      = true;                 // Alive
+        void                    Init();                                            // Subscribe caches to bw.events
+        JobSystem               jobs;                                              // Background workers
+        std::vector<Document>   documents                  = {};                   // Open documents (tabs)
+        int                     activedoc                  = 0;                    // Document in the viewport
+        bool                    tabsync                    = false;                // Tab bar behind activedoc
+        bool                    Focus                      (int doc, int window);  // Park the focused window, show another
+        void                    NewDocument                ();
+        void                    NewWindow                  ();                     // In the active document
+        void                    ShowDocuments              ();                     // Tabs + window thumbnails
+        void                    PollJobs();                                        // Collect results, start stale work
         bool                    compact                    = false;                // Compact/Spacious Switch
         bool                    wksp_create                = true;                 // Workspace "Create"
 
@@ -31,18 +75,47 @@ namespace ImStudio
         int                     previd                     = 0;                    // Previous object
         BaseObject *            selectobj                  = nullptr;              // Pointer to access
         int                     selectproparray            = 0;                    // Selected from prop array
+        int                     jumpid                     = 0;                    // Object to select (ID links)
         void                    ShowProperties();      
 
         bool                    viewport                   = true;                 // Viewport State
         ImVec2                  vp_P                       = {};                   // Viewport Pos
         ImVec2                  vp_S                       = {};                   // Viewport Size
         BufferWindow            bw;            
+        IdCheck                 idcheck                    = {};                   // Widget ID collisions
+        bool                    idstale                    = true;                 // idcheck behind the design
+        std::shared_ptr<IdCheck> idnext                    = std::make_shared<IdCheck>(); // Updated by designjob
+        JobFuture<DesignOutput> designjob                  = {};                   // Lint + codegen of a design copy
         void                    ShowViewport               (int gen_rand);         
 
         bool                    wksp_output                = false;                // Workspace "Output"
         ImVec2                  ot_P                       = {};                   // Output Window Pos
         ImVec2                  ot_S                       = {};                   // Output Window Size
         std::string             output                     = {};
+        bool                    outputstale                = true;                 // output behind design/options
+        GeneratorOptions        genopts                    = {};                   // Code generator options
+        TemplateSet             templates                  = {};                   // Loaded code templates
+        std::string             templatepath               = "templates.txt";      // Code templates file
+        std::string             templatestatus             = {};                   // Last load result
+        bool                    usetemplates               = false;                // Templates enabled
+        std::string             exportdir                  = ".";                  // Split files directory
+        std::string             exportstatus               = {};                   // Last export result
+        JobFuture<std::string>  exportjob                  = {};                   // Export, returns the status
+        bool                    hotreload                  = false;                // Rebuild the module on changes
+        bool                    hotstale                   = false;                // Module behind the design
+        std::string             hotdir                     = "hotreload";          // Module project directory
+        std::string             imguidir                   = "imgui";              // Dear ImGui sources it builds with
+        std::string             hotstatus                  = {};                   // Last build result
+        JobFuture<HotReloadBuild> hotjob                   = {};                   // Generate, write, make
+        std::string             designpath                 = "design.imstudio";    // Design file
+        std::string             designstatus               = {};                   // Last open/save/reload result
+        bool                    livereload                 = false;                // Follow external edits
+        utils::FileWatch        designwatch;                                       // Watches designpath (livereload)
+        bool                    reloadpending              = false;                // Open/reload once loadjob is free
+        bool                    reloadlive                 = false;                // Merge with designbase, else replace
+        std::shared_ptr<const DesignBase> designbase       = nullptr;              // File records last read/written
+        JobFuture<DesignIO>     loadjob                    = {};                   // Read + parse + diff
+        JobFuture<DesignIO>     savejob                    = {};                   // Write
         void                    ShowOutputWorkspace();        
 
         bool                    child_style                = false;                // Show Style Editor
@@ -52,6 +125,9 @@ namespace ImStudio
         bool                    child_stack                = false;                // Show Stack Tool
         bool                    child_resources            = false;                // Show Help Resources
         bool                    child_about                = false;                // Show About Window
+        bool                    child_minimap              = false;                // Show Minimap
+        Minimap                 minimap                    = {};                   // Of bw, kept while shown
+        void                    ShowMinimap();
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,294 @@
+#include "../includes.h"
+#include "hotreload.h"
+
+#include <chrono>
+#include <thread>
+#if !defined(__EMSCRIPTEN__) && !defined(_WIN32)
+#include <sys/stat.h>
+#endif
+
+namespace
+{
+    const char *host[] = {
+        "// Hot reload host generated by ImStudio: runs the UI module (libui.so) and loads every new build of it",
+        "// between frames. \"make host\" builds it with a GLFW + OpenGL 3 window, \"make host_headless\" without one,",
+        "// for scripts: ./host_headless [frames] runs that many frames (0 = until killed) and logs every load.",
+        "#include \"imgui.h\"",
+        "",
+        "#include <dlfcn.h>",
+        "#include <sys/stat.h>",
+        "#include <unistd.h>",
+        "#include <cstdio>",
+        "#include <cstdlib>",
+        "",
+        "#ifndef HOST_HEADLESS",
+        "#include \"imgui_impl_glfw.h\"",
+        "#include \"imgui_impl_opengl3.h\"",
+        "#include <GLFW/glfw3.h>",
+        "#endif",
+        "",
+        "struct Module",
+        "{",
+        "\tvoid *handle = nullptr;",
+        "\tunsigned (*layout)() = nullptr;",
+        "\tsize_t (*size)() = nullptr;",
+        "\tvoid *(*create)() = nullptr;",
+        "\tvoid (*destroy)(void *) = nullptr;",
+        "\tvoid (*draw)(void *) = nullptr;",
+        "};",
+        "",
+        "struct Host",
+        "{",
+        "\tconst char *path = \"./libui.so\";",
+        "\tModule module;",
+        "\tvoid *state = nullptr;  // Made by a module, kept while the next one has the same layout",
+        "\tlong long stamp = 0;    // Of the file last loaded",
+        "\tint loads = 0;",
+        "};",
+        "",
+        "// Builds are renamed over the library, so a new one is a new inode",
+        "static long long Stamp(const char *path)",
+        "{",
+        "\tstruct stat st;",
+        "\tif (stat(path, &st) != 0) return 0;",
+        "#ifdef __APPLE__",
+        "\tlong long nsec = st.st_mtimespec.tv_nsec;",
+        "#else",
+        "\tlong long nsec = st.st_mtim.tv_nsec;",
+        "#endif",
+        "\treturn ((long long)st.st_ino * 1000003LL) ^ ((long long)st.st_mtime * 1000000000LL + nsec);",
+        "}",
+        "",
+        "static bool Load(Module *m, const char *path)",
+        "{",
+        "\tm->handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);",
+        "\tif (!m->handle) return false;",
+        "\tm->layout  = (unsigned (*)())dlsym(m->handle, \"ui_layout\");",
+        "\tm->size    = (size_t (*)())dlsym(m->handle, \"ui_size\");",
+        "\tm->create  = (void *(*)())dlsym(m->handle, \"ui_create\");",
+        "\tm->destroy = (void (*)(void *))dlsym(m->handle, \"ui_destroy\");",
+        "\tm->draw    = (void (*)(void *))dlsym(m->handle, \"ui_draw\");",
+        "\tif (m->layout && m->size && m->create && m->destroy && m->draw) return true;",
+        "\tdlclose(m->handle);",
+        "\tm->handle = nullptr;",
+        "\treturn false;",
+        "}",
+        "",
+        "// Loads a new build of the module, if there is one. The running module stays when the new one does not load.",
+        "static void Poll(Host *host)",
+        "{",
+        "\tlong long stamp = Stamp(host->path);",
+        "\tif ((stamp == 0) || (stamp == host->stamp)) return;",
+        "\thost->stamp = stamp;",
+        "",
+        "\t// dlopen() hands out the library it already has for a path it has seen, so each build goes through a link",
+        "\t// of its own, removed once mapped",
+        "\tchar link_path[64];",
+        "\tsnprintf(link_path, sizeof link_path, \"./.libui.%d.%d.so\", (int)getpid(), host->loads);",
+        "\tunlink(link_path);",
+        "\tModule next;",
+        "\tbool loaded = (link(host->path, link_path) == 0) && Load(&next, link_path);",
+        "\tconst char *error = loaded ? nullptr : dlerror();",
+        "\tunlink(link_path);",
+        "\tif (!loaded)",
+        "\t{",
+        "\t\tfprintf(stderr, \"host: cannot load %s: %s\\n\", host->path, error ? error : \"link failed\");",
+        "\t\treturn;",
+        "\t}",
+        "",
+        "\tbool keep = host->state && (next.layout() == host->module.layout()) && (next.size() == host->module.size());",
+        "\tif (host->state && !keep) host->module.destroy(host->state);",
+        "\tif (!keep) host->state = next.create();",
+        "\tif (host->module.handle) dlclose(host->module.handle);",
+        "\thost->module = next;",
+        "\thost->loads++;",
+        "\tprintf(\"host: build %d loaded, state %s\\n\", host->loads, keep ? \"kept\" : \"new\");",
+        "\tfflush(stdout);",
+        "}",
+        "",
+        "static void Frame(Host *host)",
+        "{",
+        "\tPoll(host);",
+        "\tImGui::NewFrame();",
+        "\tif (host->state) host->module.draw(host->state);",
+        "\telse             ImGui::Text(\"Waiting for %s\", host->path);",
+        "\tImGui::Render();",
+        "}",
+        "",
+        "static void Unload(Host *host)",
+        "{",
+        "\tif (host->state) host->module.destroy(host->state);",
+        "\tif (host->module.handle) dlclose(host->module.handle);",
+        "\thost->state = nullptr;",
+        "\thost->module = Module();",
+        "}",
+        "",
+        "#ifdef HOST_HEADLESS",
+        "int main(int argc, char **argv)",
+        "{",
+        "\tint frames = (argc > 1) ? atoi(argv[1]) : 0;",
+        "\tHost host;",
+        "\tImGui::CreateContext();",
+        "\tImGuiIO &io = ImGui::GetIO();",
+        "\tio.DisplaySize = ImVec2(1280, 720);",
+        "\tio.DeltaTime = 1.0f / 60.0f;",
+        "\tunsigned char *pixels;",
+        "\tint w, h;",
+        "\tio.Fonts->GetTexDataAsRGBA32(&pixels, &w, &h);",
+        "\tfor (int n = 0; (frames == 0) || (n < frames); n++)",
+        "\t{",
+        "\t\tFrame(&host);",
+        "\t\tusleep(16000);",
+        "\t}",
+        "\tUnload(&host);",
+        "\tImGui::DestroyContext();",
+        "\treturn 0;",
+        "}",
+        "#else",
+        "int main(int, char **)",
+        "{",
+        "\tif (!glfwInit()) return 1;",
+        "#ifdef __APPLE__",
+        "\tconst char *glsl_version = \"#version 150\";",
+        "\tglfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);",
+        "\tglfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 2);",
+        "\tglfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);",
+        "\tglfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);",
+        "#else",
+        "\tconst char *glsl_version = \"#version 130\";",
+        "\tglfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);",
+        "\tglfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);",
+        "#endif",
+        "\tGLFWwindow *window = glfwCreateWindow(1280, 720, \"Hot reload host\", NULL, NULL);",
+        "\tif (!window) return 1;",
+        "\tglfwMakeContextCurrent(window);",
+        "\tglfwSwapInterval(1);",
+        "",
+        "\tHost host;",
+        "\tImGui::CreateContext();",
+        "\tImGui_ImplGlfw_InitForOpenGL(window, true);",
+        "\tImGui_ImplOpenGL3_Init(glsl_version);",
+        "\twhile (!glfwWindowShouldClose(window))",
+        "\t{",
+        "\t\tglfwPollEvents();",
+        "\t\tImGui_ImplOpenGL3_NewFrame();",
+        "\t\tImGui_ImplGlfw_NewFrame();",
+        "\t\tFrame(&host);",
+        "\t\tint w, h;",
+        "\t\tglfwGetFramebufferSize(window, &w, &h);",
+        "\t\tglViewport(0, 0, w, h);",
+        "\t\tglClearColor(0.1f, 0.1f, 0.1f, 1.0f);",
+        "\t\tglClear(GL_COLOR_BUFFER_BIT);",
+        "\t\tImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());",
+        "\t\tglfwSwapBuffers(window);",
+        "\t}",
+        "\tUnload(&host);",
+        "\tImGui_ImplOpenGL3_Shutdown();",
+        "\tImGui_ImplGlfw_Shutdown();",
+        "\tImGui::DestroyContext();",
+        "\tglfwDestroyWindow(window);",
+        "\tglfwTerminate();",
+        "\treturn 0;",
+        "}",
+        "#endif",
+    };
+
+    std::string Lines(const char *const *lines, size_t count)
+    {
+        std::string text;
+        for (size_t n = 0; n < count; n++)
+        {
+            text += lines[n];
+            text += "\n";
+        }
+        return text;
+    }
+
+    std::string Makefile(const std::vector<ImStudio::GeneratedFile> &files, const std::string &imguidir)
+    {
+        std::string objects;
+        std::string headers;
+        for (const ImStudio::GeneratedFile &f : files)
+        {
+            size_t dot = f.name.rfind('.');
+            std::string ext = (dot == std::string::npos) ? "" : f.name.substr(dot);
+            if (ext == ".cpp") objects += " " + f.name.substr(0, dot) + ".o";
+            if (ext == ".h")   headers += " " + f.name;
+        }
+
+        std::string text;
+        text += "# Hot reload project generated by ImStudio\n";
+        text += "#   make                 the UI module, libui.so (ImStudio runs this on every change)\n";
+        text += "#   make host            host with a GLFW + OpenGL 3 window: ./host\n";
+        text += "#   make host_headless   host without a window, for scripts: ./host_headless [frames]\n";
+        text += "# Both hosts run in this directory and pick up every new libui.so between frames.\n\n";
+        text += fmt::format("IMGUI_DIR ?= {}\n", imguidir);
+        text += "CXXFLAGS  ?= -std=c++11 -O0 -g\n";
+        text += "CPPFLAGS  += -I$(IMGUI_DIR) -I$(IMGUI_DIR)/backends   # add the directory of the data header, if any\n\n";
+        text += fmt::format("UI_OBJECTS    ={}\n", objects);
+        text += fmt::format("UI_HEADERS    ={}\n", headers);
+        text += "IMGUI_SOURCES = $(IMGUI_DIR)/imgui.cpp $(IMGUI_DIR)/imgui_draw.cpp $(IMGUI_DIR)/imgui_tables.cpp "
+                "$(IMGUI_DIR)/imgui_widgets.cpp\n\n";
+        text += "module: libui.so\n\n";
+        text += "# linked next to the running one and renamed over it, so a host never loads a half written library\n";
+        text += "libui.so: $(UI_OBJECTS)\n";
+        text += "\t$(CXX) -shared -o $@.tmp $(UI_OBJECTS) && mv -f $@.tmp $@\n\n";
+        text += "%.o: %.cpp $(UI_HEADERS)\n";
+        text += "\t$(CXX) $(CXXFLAGS) $(CPPFLAGS) -fPIC -c $< -o $@\n\n";
+        text += "# the hosts export their ImGui (-rdynamic): the module leaves it undefined and shares the host's context\n";
+        text += "host: host.cpp $(IMGUI_SOURCES) $(IMGUI_DIR)/backends/imgui_impl_glfw.cpp $(IMGUI_DIR)/backends/imgui_impl_opengl3.cpp\n";
+        text += "\t$(CXX) $(CXXFLAGS) $(CPPFLAGS) -rdynamic $^ -o $@ -ldl -lglfw -lGL\n\n";
+        text += "host_headless: host.cpp $(IMGUI_SOURCES)\n";
+        text += "\t$(CXX) $(CXXFLAGS) $(CPPFLAGS) -DHOST_HEADLESS -rdynamic $^ -o $@ -ldl\n\n";
+        text += ".PHONY: module\n";
+        return text;
+    }
+}
+
+void ImStudio::HotReloadProject(std::vector<GeneratedFile>* files, BufferWindow* bw, const GeneratorOptions& opts,
+                                const std::string &imguidir)
+{
+    GenerateModule(files, bw, opts);
+    GeneratedFile makefile;
+    makefile.name = "Makefile";
+    makefile.text = Makefile(*files, imguidir);
+    GeneratedFile hostfile;
+    hostfile.name = "host.cpp";
+    hostfile.text = Lines(host, IM_ARRAYSIZE(host));
+    files->push_back(makefile);
+    files->push_back(hostfile);
+}
+
+ImStudio::HotReloadBuild ImStudio::BuildModule(const std::vector<GeneratedFile>& files, const std::string &dir)
+{
+    HotReloadBuild build;
+    auto start = std::chrono::steady_clock::now();
+#if defined(__EMSCRIPTEN__) || defined(_WIN32)
+    (void)files;
+    build.log = fmt::format("Hot reload needs make, a compiler and dlopen(), {} is not written", dir);
+#else
+    mkdir(dir.c_str(), 0755); // fails once it exists
+    if (!WriteFiles(files, dir, &build.changed))
+    {
+        build.log = fmt::format("Could not write to {}", dir);
+        return build;
+    }
+
+    // make recompiles only the sources WriteFiles() rewrote
+    unsigned    threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string command = fmt::format("make -C '{}' -j{} module 2>&1", dir, threads);
+    FILE *pipe = popen(command.c_str(), "r");
+    if (!pipe)
+    {
+        build.log = "Could not run make";
+        return build;
+    }
+    char   chunk[4096];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), pipe)) > 0)
+        build.log.append(chunk, read);
+    build.ok = (pclose(pipe) == 0);
+#endif
+    build.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return build;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "../includes.h"
+#include "buffer.h"
+#include "generator.h"
+
+namespace ImStudio
+{
+
+    // Hot reload project of a design: the generated UI built as a shared library (the module, libui.so) and a small
+    // host that runs it. Between frames the host checks the library and dlopen()s every new build, keeping the
+    // state struct while its layout is the same; make only recompiles the sources WriteFiles() rewrote.
+    struct HotReloadBuild
+    {
+        bool                    ok                         = false;                //
+        int                     changed                    = 0;                    // Files rewritten
+        double                  seconds                    = 0.0;                  // Write + compile + link
+        std::string             log                        = {};                   // Output of make
+    };
+
+    void HotReloadProject       (std::vector<GeneratedFile>* files, BufferWindow* bw, const GeneratorOptions& opts,
+                                 const std::string &imguidir);                     // Module, host.cpp, Makefile
+    HotReloadBuild BuildModule  (const std::vector<GeneratedFile>& files, const std::string &dir); // Write, make module
+
+}
@@ -0,0 +1,130 @@
+#include "../includes.h"
+#include "jobs.h"
+
+namespace
+{
+    thread_local int worker_index = -1;                                            // Deque of this thread, -1 = not a worker
+}
+
+ImStudio::JobSystem::JobSystem(int count)
+{
+#ifdef __EMSCRIPTEN__
+    count = 0;
+#else
+    if (count < 0)
+        count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+#endif
+    for (int n = 0; n < count; n++)
+        queues.emplace_back(new Worker());
+    for (int n = 0; n < count; n++)
+        threads.emplace_back(&JobSystem::loop, this, n);
+}
+
+ImStudio::JobSystem::~JobSystem()
+{
+    for (std::unique_ptr<Worker> &q : queues)
+    {
+        std::lock_guard<std::mutex> hold(q->lock);
+        for (std::shared_ptr<JobState> &job : q->jobs)
+            job->cancel = true;
+    }
+    {
+        std::lock_guard<std::mutex> hold(sleep);
+        quit = true;
+    }
+    wake.notify_all();
+    for (std::thread &t : threads)
+        t.join();
+}
+
+void ImStudio::JobSystem::execute(JobState &job)
+{
+    int expected = JOB_QUEUED;
+    if (!job.status.compare_exchange_strong(expected, JOB_RUNNING)) return;
+    if (!job.cancelled()) job.run(job);
+    job.run = nullptr;
+    job.status = job.cancelled() ? JOB_CANCELLED : JOB_DONE;
+}
+
+void ImStudio::JobSystem::push(const std::shared_ptr<JobState> &job)
+{
+    if (worker_index < 0)
+    {
+        submitted.erase(std::remove_if(submitted.begin(), submitted.end(),
+                                       [](const std::shared_ptr<JobState> &j) { return j->finished(); }),
+                        submitted.end());
+        submitted.push_back(job);
+    }
+
+    if (queues.empty())
+    {
+        execute(*job);
+        return;
+    }
+
+    int self = (worker_index >= 0) ? worker_index : static_cast<int>(next++ % queues.size());
+    {
+        std::lock_guard<std::mutex> hold(queues[self]->lock);
+        queues[self]->jobs.push_back(job);
+    }
+    {
+        std::lock_guard<std::mutex> hold(sleep);
+        pending++;
+    }
+    wake.notify_one();
+}
+
+std::shared_ptr<ImStudio::JobState> ImStudio::JobSystem::take(int self)
+{
+    std::shared_ptr<JobState> job;
+    {
+        Worker &own = *queues[self];
+        std::lock_guard<std::mutex> hold(own.lock);
+        if (!own.jobs.empty())
+        {
+            job = own.jobs.back();
+            own.jobs.pop_back();
+        }
+    }
+    for (size_t n = 1; !job && (n < queues.size()); n++)
+    {
+        Worker &victim = *queues[(self + n) % queues.size()];
+        std::lock_guard<std::mutex> hold(victim.lock);
+        if (!victim.jobs.empty())
+        {
+            job = victim.jobs.front();
+            victim.jobs.pop_front();
+        }
+    }
+    if (job)
+    {
+        std::lock_guard<std::mutex> hold(sleep);
+        pending--;
+    }
+    return job;
+}
+
+void ImStudio::JobSystem::loop(int self)
+{
+    worker_index = self;
+    for (;;)
+    {
+        std::shared_ptr<JobState> job = take(self);
+        if (job)
+        {
+            execute(*job);
+            continue;
+        }
+        std::unique_lock<std::mutex> hold(sleep);
+        wake.wait(hold, [this] { return quit || (pending > 0); });
+        if (quit) break;
+    }
+}
+
+std::vector<std::shared_ptr<ImStudio::JobState>> ImStudio::JobSystem::active()
+{
+    std::vector<std::shared_ptr<JobState>> list;
+    for (const std::shared_ptr<JobState> &job : submitted)
+        if (!job->finished()) list.push_back(job);
+    return list;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "../includes.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace ImStudio
+{
+
+    enum JobStatus
+    {
+        JOB_QUEUED,                                                                // Waiting in a worker deque
+        JOB_RUNNING,                                                               // Picked up by a worker
+        JOB_DONE,                                                                  // Finished, result is set
+        JOB_CANCELLED                                                              // Dropped before/while running
+    };
+
+    // Shared between the submitter and the worker running the job. Jobs poll cancelled() at convenient points and
+    // report progress in [0, 1] (negative = unknown); the UI thread only reads.
+    struct JobState
+    {
+        std::string             name                       = {};                   // Shown by the progress indicator
+        std::atomic<int>        status                     {JOB_QUEUED};           // JobStatus
+        std::atomic<bool>       cancel                     {false};                // Requested by the submitter
+        std::atomic<float>      progress                   {-1.0f};                // [0, 1], -1 = unknown
+        std::function<void(JobState &)> run                = {};                   // Body, cleared once run
+
+        bool                    cancelled                  () const { return cancel.load(std::memory_order_relaxed); }
+        bool                    finished                   () const { return status.load() >= JOB_DONE; }
+    };
+
+    // Result of a submitted job. ready() never blocks; get() is only valid once ready() and not cancelled.
+    template <typename T> struct JobFuture
+    {
+        std::shared_ptr<JobState> state                    = nullptr;
+        std::shared_ptr<T>      result                     = nullptr;
+
+        bool                    valid                      () const { return state != nullptr; }
+        bool                    ready                      () const { return state && (state->status.load() == JOB_DONE); }
+        bool                    running                    () const { return state && !state->finished(); }
+        void                    cancel                     () { if (state) state->cancel = true; }
+        T &                     get                        () { return *result; }
+        void                    reset                      () { state = nullptr; result = nullptr; }
+    };
+
+    // Fixed pool of workers, one deque each. A worker pops its own newest job and steals the oldest job of the
+    // others when it runs dry; jobs submitted from a worker go to its own deque, the rest round-robin. With no
+    // threads (web build) submit() runs the job inline.
+    class JobSystem
+    {
+      public:
+        explicit                JobSystem                  (int threads = -1);     // -1 = hardware threads - 1
+                                ~JobSystem                 ();
+
+        template <typename T>
+        JobFuture<T>            submit                     (const std::string &name, std::function<T(JobState &)> fn)
+        {
+            JobFuture<T> future;
+            future.state        = std::make_shared<JobState>();
+            future.result       = std::make_shared<T>();
+            future.state->name  = name;
+            std::shared_ptr<T> result = future.result;
+            future.state->run   = [fn, result](JobState &job) { *result = fn(job); };
+            push(future.state);
+            return future;
+        }
+
+        int                     workers                    () const { return static_cast<int>(threads.size()); }
+        std::vector<std::shared_ptr<JobState>> active      ();                     // Queued or running, oldest first
+
+      private:
+        struct Worker
+        {
+            std::mutex                              lock;
+            std::deque<std::shared_ptr<JobState>>   jobs;
+        };
+
+        std::vector<std::unique_ptr<Worker>> queues        = {};
+        std::vector<std::thread> threads                   = {};
+        std::mutex              sleep                      = {};                   // Guards pending/quit for the cv
+        std::condition_variable wake                       = {};
+        int                     pending                    = 0;                    // Jobs in all deques
+        bool                    quit                       = false;
+        unsigned                next                       = 0;                    // Round-robin deque
+        std::vector<std::shared_ptr<JobState>> submitted   = {};                   // For active(), UI thread only
+
+        void                    push                       (const std::shared_ptr<JobState> &job);
+        std::shared_ptr<JobState> take                     (int self);
+        void                    loop                       (int self);
+        static void             execute                    (JobState &job);
+    };
+
+}
@@ -0,0 +1,192 @@
+#include "../includes.h"
+#include "minimap.h"
+
+namespace
+{
+    using namespace ImStudio;
+
+    const ImU32 kindcolors[MAP_COUNT] = {
+        IM_COL32(120, 120, 120, 150),                                              // MAP_CONTAINER
+        IM_COL32(205, 205, 205, 170),                                              // MAP_DISPLAY
+        IM_COL32(66, 150, 250, 220),                                               // MAP_WIDGET
+    };
+    const int batch = 8192;                                                        // Runs per PrimReserve
+    const int spare = 1024;                                                        // Vertices left to the window
+    static_assert(Minimap::cols * Minimap::rows * 4 + spare < 0x10000, "one run per cell must fit 16-bit indices");
+
+    int Kind(const std::string &type)
+    {
+        static const char *display[] = {"text", "bullet", "separator", "sameline", "newline", "image",
+                                        "plotlines", "plothistogram", "progressbar", "textlog"};
+        if (IsContainer(type)) return MAP_CONTAINER;
+        for (const char *d : display)
+            if (type == d) return MAP_DISPLAY;
+        return MAP_WIDGET;
+    }
+
+    // Design rect of a top level object: child windows by their grabs, the rest by their last drawn size
+    ImRect Bounds(const Object &o)
+    {
+        if (o.type == "child") return o.child.freerect;
+        return ImRect(o.pos.x, o.pos.y, o.pos.x + ImMax(o.size.x, 1.0f), o.pos.y + ImMax(o.size.y, 1.0f));
+    }
+}
+
+void ImStudio::Minimap::update(const BaseObject *obj)
+{
+    if (stale) return; // rebuilt by the next draw()
+    if (!obj)
+    {
+        stale = true; // window size, layout, reset
+        return;
+    }
+    if (obj->ischildwidget) return; // inside its container's rect
+
+    auto found = entries.find(obj->id);
+    if (found != entries.end())
+    {
+        bin(found->second, -1);
+        entries.erase(found);
+    }
+    if (!obj->state) return;
+
+    Entry e;
+    e.rect = Bounds(static_cast<const Object &>(*obj));
+    e.kind = Kind(obj->type);
+    if (!bin(e, 1))
+    {
+        stale = true; // moved off the grid: fit it to the design again
+        return;
+    }
+    entries[obj->id] = e;
+}
+
+void ImStudio::Minimap::build(const BufferWindow &bw)
+{
+    // the grid covers the window and every object, with a margin to the right and below so that most moves and new
+    // objects stay on it
+    ImRect area(ImVec2(0, 0), bw.size);
+    for (const Object &o : bw.objects)
+        if (o.state) area.Add(Bounds(o));
+    float margin = ImMax(area.GetWidth(), area.GetHeight()) * 0.25f;
+    area.Max.x  += margin;
+    area.Max.y  += margin;
+    cell   = ImMax(ImMax(area.GetWidth() / cols, area.GetHeight() / rows), 1.0f);
+    origin = area.Min;
+
+    entries.clear();
+    entries.reserve(bw.objects.size());
+    counts.assign(cols * rows * MAP_COUNT, 0);
+    runs.clear();
+    colors.clear();
+    rowruns.assign(rows + 1, 0);
+    for (const Object &o : bw.objects)
+    {
+        if (!o.state) continue;
+        Entry e;
+        e.rect = Bounds(o);
+        e.kind = Kind(o.type);
+        bin(e, 1);
+        entries[o.id] = e;
+    }
+    stale       = false;
+    dirtytop    = 0;
+    dirtybottom = rows - 1;
+}
+
+bool ImStudio::Minimap::bin(const Entry &e, int delta)
+{
+    int x0 = (int)floorf((e.rect.Min.x - origin.x) / cell);
+    int y0 = (int)floorf((e.rect.Min.y - origin.y) / cell);
+    int x1 = ImMax((int)floorf((e.rect.Max.x - origin.x) / cell), x0);
+    int y1 = ImMax((int)floorf((e.rect.Max.y - origin.y) / cell), y0);
+    if ((x0 < 0) || (y0 < 0) || (x1 >= cols) || (y1 >= rows)) return false;
+    for (int y = y0; y <= y1; y++)
+        for (int x = x0; x <= x1; x++)
+            counts[(y * cols + x) * MAP_COUNT + e.kind] += delta;
+    dirtytop    = ImMin(dirtytop, y0);
+    dirtybottom = ImMax(dirtybottom, y1);
+    return true;
+}
+
+// One run per stretch of cells in a row whose topmost kind (widgets over display over containers) is the same. Only
+// the dirty rows are merged, their runs replace the old ones in place.
+void ImStudio::Minimap::merge()
+{
+    std::vector<ImRect> merged;
+    std::vector<ImU32>  mergedcolors;
+    std::vector<int>    starts;
+    for (int y = dirtytop; y <= dirtybottom; y++)
+    {
+        starts.push_back((int)merged.size());
+        int run = -1;                                                              // Kind of the open run
+        for (int x = 0; x <= cols; x++)
+        {
+            int kind = -1;
+            for (int k = MAP_COUNT - 1; (x < cols) && (k >= 0) && (kind < 0); k--)
+                if (counts[(y * cols + x) * MAP_COUNT + k]) kind = k;
+            if (kind == run) continue;
+            if (run >= 0) merged.back().Max.x = (float)x;
+            if (kind >= 0)
+            {
+                merged.push_back(ImRect((float)x, (float)y, (float)x + 1, (float)y + 1));
+                mergedcolors.push_back(kindcolors[kind]);
+            }
+            run = kind;
+        }
+    }
+
+    int begin = rowruns[dirtytop];
+    int end   = rowruns[dirtybottom + 1];
+    int shift = (int)merged.size() - (end - begin);
+    runs.erase(runs.begin() + begin, runs.begin() + end);
+    runs.insert(runs.begin() + begin, merged.begin(), merged.end());
+    colors.erase(colors.begin() + begin, colors.begin() + end);
+    colors.insert(colors.begin() + begin, mergedcolors.begin(), mergedcolors.end());
+    for (int y = dirtytop; y <= dirtybottom; y++)
+        rowruns[y] = begin + starts[y - dirtytop];
+    for (int y = dirtybottom + 1; y <= rows; y++)
+        rowruns[y] += shift;
+    dirtytop    = rows;
+    dirtybottom = -1;
+}
+
+bool ImStudio::Minimap::draw(const BufferWindow &bw, ImVec2 size, ImVec2 *target)
+{
+    if (stale) build(bw);
+    if (dirtytop <= dirtybottom) merge();
+
+    // the grid letterboxed into size; px: pixels per design unit
+    float       scale = ImMax(ImMin(size.x / cols, size.y / rows), 0.25f);
+    float       px    = scale / cell;
+    ImVec2      min   = ImGui::GetCursorScreenPos();
+    ImVec2      max   = ImVec2(min.x + cols * scale, min.y + rows * scale);
+    ImDrawList *dl    = ImGui::GetWindowDrawList();
+    ImGui::InvisibleButton("minimap", ImVec2(max.x - min.x, max.y - min.y));
+    dl->AddRectFilled(min, max, IM_COL32(20, 23, 23, 255));
+    dl->AddRect(ImVec2(min.x - origin.x * px, min.y - origin.y * px),
+                ImVec2(min.x + (bw.size.x - origin.x) * px, min.y + (bw.size.y - origin.y) * px), IM_COL32(88, 88, 88, 255));
+
+    // without vertex offsets the draw list cannot start a new 16-bit range: the grid is sized for that, this only
+    // keeps whatever the window drew before the map from pushing it over
+    size_t drawn = runs.size();
+    if (!(ImGui::GetIO().BackendFlags & ImGuiBackendFlags_RendererHasVtxOffset))
+        drawn = ImMin(drawn, (size_t)ImMax(0x10000 - spare - (int)dl->_VtxCurrentIdx, 0) / 4);
+    for (size_t n = 0; n < drawn; n += batch)
+    {
+        size_t count = ImMin(drawn - n, (size_t)batch);
+        dl->PrimReserve((int)count * 6, (int)count * 4);
+        for (size_t r = n; r < n + count; r++)
+            dl->PrimRect(ImVec2(min.x + runs[r].Min.x * scale, min.y + runs[r].Min.y * scale),
+                         ImVec2(min.x + runs[r].Max.x * scale, min.y + runs[r].Max.y * scale), colors[r]);
+    }
+
+    // the part of the design the buffer window shows
+    ImVec2 view = ImVec2(min.x + (bw.scroll.x - origin.x) * px, min.y + (bw.scroll.y - origin.y) * px);
+    dl->AddRect(view, ImVec2(view.x + bw.size.x * px, view.y + bw.size.y * px), IM_COL32(255, 255, 255, 200));
+
+    if (!ImGui::IsItemActive()) return false; // clicked or dragged
+    ImVec2 mouse = ImGui::GetIO().MousePos;
+    *target = ImVec2(origin.x + (mouse.x - min.x) / px, origin.y + (mouse.y - min.y) / px);
+    return true;
+}
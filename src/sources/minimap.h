@@ -0,0 +1,56 @@
+#pragma once
+
+#include "../includes.h"
+#include "object.h"
+#include "buffer.h"
+
+#include <unordered_map>
+
+namespace ImStudio
+{
+
+    enum MinimapKind
+    {
+        MAP_CONTAINER,                                                             // Child window, tree node
+        MAP_DISPLAY,                                                               // Text, images, plots, spacing
+        MAP_WIDGET,                                                                // Everything interactive
+        MAP_COUNT
+    };
+
+    // Scaled overview of a design. Top level objects are binned into a grid of cells as their change events come in
+    // (update() only touches the cells of the object that changed), the rows an edit touched are merged into runs
+    // again before the next draw, and draw() writes the runs into the draw list a few reserved batches at a time, so
+    // a frame costs the same for 100 or 100k objects. Even one run per cell stays under 65536 vertices, the limit of
+    // 16-bit indices on renderers without vertex offsets (WebGL).
+    struct Minimap
+    {
+        static const int        cols                       = 128;                  //-- Grid cells
+        static const int        rows                       = 96;                   //--
+
+        struct Entry
+        {
+            ImRect              rect                       = {};                   // As binned
+            int                 kind                       = MAP_WIDGET;           // MinimapKind
+        };
+
+        std::unordered_map<int, Entry> entries             = {};                   // Object id -> entry
+        std::vector<unsigned>   counts                     = {};                   // Objects per cell and kind
+        ImVec2                  origin                     = {};                   //-- Design area of the grid,
+        float                   cell                       = 0.0f;                 //-- cols x rows square cells
+        std::vector<ImRect>     runs                       = {};                   //-- Cells of one kind in a row,
+        std::vector<ImU32>      colors                     = {};                   //-- in grid units, row by row
+        std::vector<int>        rowruns                    = {};                   // First run of each row, then the end
+        bool                    stale                      = true;                 // Rebuild from the design
+        int                     dirtytop                   = 0;                    //-- Rows whose runs are behind
+        int                     dirtybottom                = -1;                   //-- the counts
+
+        void                    update                     (const BaseObject *obj); // From a change event
+        void                    build                      (const BufferWindow &bw);
+        bool                    draw                       (const BufferWindow &bw, ImVec2 size, ImVec2 *target); // Clicked: design point
+
+      private:
+        bool                    bin                        (const Entry &e, int delta); // False if outside the grid
+        void                    merge                      ();
+    };
+
+}
@@ -1,6 +1,8 @@
 #include "../includes.h"
 #include "object.h"
 
+#include <map>
+
 ImStudio::BaseObject::BaseObject(int idvar_, std::string type_, int parent_id_) // for child widgets
 {
     ischildwidget = true;
@@ -8,11 +10,26 @@ ImStudio::BaseObject::BaseObject(int idvar_, std::string type_, int parent_id_)
     type          = type_;
     identifier    = "child" + std::to_string(parent_id_) + "::" + type_ + std::to_string(idvar_);
     value_s       = type_ + std::to_string(idvar_);
+    if (IsPlot(type_) || (type_ == "textlog"))
+    {
+        value_s.clear(); // data source, none bound yet
+        size.y = IsPlot(type_) ? 80 : 160;
+    }
+    if (type_ == "image")
+    {
+        value_s = type_ + std::to_string(idvar_) + ".png"; // source
+        size    = ImVec2(32, 32);
+    }
+    if (type_ == "treenode")
+    {
+        value_s.clear(); // lazy children source, none bound yet
+        value_b = true;  // expanded
+    }
 }
 
 ImStudio::Object::Object(int idvar_, std::string type_) : BaseObject()
 {
-    if (type_ == "child")
+    if (IsContainer(type_))
     {
         child.objects.reserve(250);
         child.open = true;
@@ -23,10 +40,151 @@ ImStudio::Object::Object(int idvar_, std::string type_) : BaseObject()
     identifier = type_ + std::to_string(idvar_);
     value_s    = type_ + std::to_string(idvar_);
     parent     = this;
+    if (IsPlot(type_) || (type_ == "textlog"))
+    {
+        value_s.clear(); // data source, none bound yet
+        size.y = IsPlot(type_) ? 80 : 160;
+    }
+    if (type_ == "image")
+    {
+        value_s = type_ + std::to_string(idvar_) + ".png"; // source
+        size    = ImVec2(32, 32);
+    }
+    if (type_ == "treenode")
+    {
+        value_s.clear(); // lazy children source, none bound yet
+        value_b = true;  // expanded, so the widgets added to it show
+    }
+}
+
+namespace
+{
+    bool ListItem(void *data, int n, const char **text)
+    {
+        *text = (*static_cast<const ImStudio::ItemList *>(data))[n];
+        return true;
+    }
+
+    // Telemetry-like series of 1M points shown by every plot widget, decimated once per width. Going through
+    // the same kernel as the generated code keeps the preview honest about what the spikes will look like.
+    const std::vector<float> &PreviewPlot(int buckets)
+    {
+        static std::vector<float> series;
+        static std::map<int, std::vector<float>> decimated;
+        if (series.empty())
+        {
+            unsigned noise = 1;
+            series.resize(1 << 20);
+            for (size_t i = 0; i < series.size(); i++)
+            {
+                noise     = noise * 1664525u + 1013904223u;
+                series[i] = sinf(i * 0.00002f) + 0.25f * sinf(i * 0.0007f) + 0.1f * ((noise >> 16) / 65535.0f);
+                if ((noise >> 8) % 50000 == 0) series[i] += 1.0f; // single-sample spikes
+            }
+        }
+        buckets = ImMax(buckets, 1);
+        std::vector<float> &points = decimated[buckets];
+        if (points.empty())
+        {
+            points.resize(buckets * 2);
+            utils::DecimateMinMax(series.data(), (int)series.size(), buckets, points.data());
+        }
+        return points;
+    }
+
+    // Lazy children shown under every tree node with a source: a thousand nodes of a thousand leaves each. Rows of
+    // the open part are kept flattened and drawn through a clipper, as the generated LazyTree does.
+    struct PreviewTree
+    {
+        ImGuiStorage            open;                                           // node -> expanded
+        ImVector<int>           rows;                                           //-- Flattened open part
+        ImVector<int>           depths;                                         //--
+        bool                    flat                    = false;                // rows are up to date
+
+        static int count(int node) { return (node < 1000) ? 1000 : 0; }         // node -1: the root
+        static int child(int node, int n) { return (node < 0) ? n : 1000 + node * 1000 + n; }
+
+        void flatten(int node, int depth)
+        {
+            for (int n = 0, c = count(node); n < c; n++)
+            {
+                int id = child(node, n);
+                rows.push_back(id);
+                depths.push_back(depth);
+                if (open.GetBool((ImGuiID)id)) flatten(id, depth + 1);
+            }
+        }
+
+        void draw()
+        {
+            if (!flat)
+            {
+                rows.resize(0);
+                depths.resize(0);
+                flatten(-1, 0);
+                flat = true;
+            }
+            float indent = ImGui::GetStyle().IndentSpacing;
+            float x      = ImGui::GetCursorPosX();
+            ImGuiListClipper clipper;
+            clipper.Begin(rows.Size);
+            while (clipper.Step())
+            {
+                for (int r = clipper.DisplayStart; r < clipper.DisplayEnd; r++)
+                {
+                    int  node = rows[r];
+                    bool was  = open.GetBool((ImGuiID)node);
+                    ImGui::SetCursorPosX(x + depths[r] * indent);
+                    ImGui::SetNextItemOpen(was);
+                    ImGui::PushID(node);
+                    bool now = ImGui::TreeNodeEx("##node", ImGuiTreeNodeFlags_NoTreePushOnOpen |
+                                                 (count(node) ? 0 : ImGuiTreeNodeFlags_Leaf), "node %d", node);
+                    ImGui::PopID();
+                    if (now == was) continue;
+                    open.SetBool((ImGuiID)node, now);
+                    flat = false;
+                }
+            }
+        }
+    };
+
+    // Log shown by every text log widget: a few MB to start with, then a stream of lines so the preview shows
+    // the index growing while only a screenful is submitted
+    struct PreviewLog
+    {
+        ImGuiTextBuffer         text;
+        ImVector<int>           lines;
+        int                     frame                   = -1;                   // Last frame lines came in
+    };
+
+    PreviewLog &Log()
+    {
+        static PreviewLog log;
+        static unsigned   seq = 0;
+        if ((log.frame == ImGui::GetFrameCount()) && !log.lines.empty()) return log;
+        if (log.text.size() > (16 << 20))
+        {
+            log.text.clear();
+            log.lines.clear();
+        }
+        int count = log.lines.empty() ? 100000 : 50; // ~3000 lines/s once running
+        char line[128];
+        for (int n = 0; n < count; n++, seq++)
+        {
+            static const char *levels[] = {"info ", "debug", "warn ", "error"};
+            int len = snprintf(line, sizeof(line), "[%08u] %s worker %u: frame %u done in %u us\n", seq,
+                               levels[(seq * 7) % 97 % 4], seq % 8, seq / 8, 900 + (seq * 37) % 400);
+            utils::AppendLines(&log.text, &log.lines, line, line + len);
+        }
+        log.frame = ImGui::GetFrameCount();
+        return log;
+    }
 }
 
-void ImStudio::BaseObject::draw(int *select, int gen_rand, bool staticlayout = false)
+// True if the preview widget itself was edited (typed into, checked, picked), which no drag or resize tells.
+bool ImStudio::BaseObject::draw(int *select, int gen_rand, bool staticlayout = false)
 {
+    bool edited = false;
     if (state)
     {
         if (type == "button")
@@ -67,7 +225,7 @@ void ImStudio::BaseObject::draw(int *select, int gen_rand, bool staticlayout = f
                 ImGui::SetCursorPos(pos);
             ImGui::PushID(id);
 
-            ImGui::Checkbox(label.c_str(), &value_b);
+            edited |= ImGui::Checkbox(label.c_str(), &value_b);
 
             ImGui::PopID();
             if ((!locked) && (ImGui::IsItemActive()))
@@ -140,7 +298,7 @@ void ImStudio::BaseObject::draw(int *select, int gen_rand, bool staticlayout = f
             ImGui::PushItemWidth(width);
             if (!staticlayout)
                 ImGui::SetCursorPos(pos);
-            ImGui::InputText(label.c_str(), &value_s);
+            edited |= ImGui::InputText(label.c_str(), &value_s);
 
             ImGui::PopItemWidth();
             ImGui::PopID();
@@ -188,8 +346,21 @@ void ImStudio::BaseObject::draw(int *select, int gen_rand, bool staticlayout = f
                 ImGui::SetCursorPos(pos);
             ImGui::PushID(id);
 
-            const char *items[] = {"Never", "Gonna", "Give", "You", "Up"};
-            ImGui::Combo(label.c_str(), &item_current, items, IM_ARRAYSIZE(items));
+            // ImGui::Combo() submits every item of an open popup, this only the visible ones
+            int current = ImClamp(item_current, 0, ImMax(itemlist.count() - 1, 0));
+            if (ImGui::BeginCombo(label.c_str(), (itemlist.count() > 0) ? itemlist[current] : ""))
+            {
+                ImGuiListClipper clipper;
+                clipper.Begin(itemlist.count());
+                while (clipper.Step())
+                    for (int n = clipper.DisplayStart; n < clipper.DisplayEnd; n++)
+                        if (ImGui::Selectable(itemlist[n], n == current))
+                        {
+                            item_current = n;
+                            edited       = true;
+                        }
+                ImGui::EndCombo();
+            }
 
             ImGui::PopID();
             ImGui::PopItemWidth();
@@ -212,8 +383,7 @@ void ImStudio::BaseObject::draw(int *select, int gen_rand, bool staticlayout = f
                 ImGui::SetCursorPos(pos);
             ImGui::PushID(id);
 
-            const char *items[] = {"Never", "Gonna", "Give", "You", "Up"};
-            ImGui::ListBox(label.c_str(), &item_current, items, IM_ARRAYSIZE(items));
+            edited |= ImGui::ListBox(label.c_str(), &item_current, ListItem, &itemlist, itemlist.count()); // clipped by ImGui
 
             ImGui::PopID();
             ImGui::PopItemWidth();
@@ -687,7 +857,192 @@ void ImStudio::BaseObject::draw(int *select, int gen_rand, bool staticlayout = f
             }
             highlight(select);
         }
+        if (type == "treenode")
+        {
+            if (!staticlayout)
+                ImGui::SetCursorPos(pos);
+            ImGui::PushID(id);
+
+            // the Expanded property opens it: a click in the viewport selects and drags, like on any widget
+            ImGui::SetNextItemOpen(value_b);
+            ImGui::TreeNodeEx(label.c_str(), ImGuiTreeNodeFlags_NoTreePushOnOpen);
+
+            ImGui::PopID();
+            if ((!locked) && (utils::IsItemActiveAlt(pos, id)))
+            {
+                ImGui::SetMouseCursor(ImGuiMouseCursor_ResizeAll);
+                pos     = utils::GetLocalCursor();
+                *select = id;
+            }
+            if ((!staticlayout) && (center_h))
+            {
+                pos.x = utils::CenterHorizontal();
+            }
+            highlight(select);
+        }
+        if (type == "image")
+        {
+            if (!staticlayout)
+                ImGui::SetCursorPos(pos);
+
+            // no textures in the designer: a framed placeholder of the cell the image gets in the atlas
+            ImGui::Dummy(size);
+            ImDrawList *draw = ImGui::GetWindowDrawList();
+            ImVec2      min  = ImGui::GetItemRectMin();
+            ImVec2      max  = ImGui::GetItemRectMax();
+            ImU32       col  = ImGui::GetColorU32(ImGuiCol_TextDisabled);
+            draw->AddRect(min, max, col);
+            draw->AddLine(min, max, col);
+            draw->AddLine(ImVec2(min.x, max.y), ImVec2(max.x, min.y), col);
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("%s", value_s.c_str());
+
+            if ((!locked) && (utils::IsItemActiveAlt(pos, id)))
+            {
+                ImGui::SetMouseCursor(ImGuiMouseCursor_ResizeAll);
+                pos     = utils::GetLocalCursor();
+                *select = id;
+            }
+            if ((!staticlayout) && (center_h))
+            {
+                pos.x = utils::CenterHorizontal();
+            }
+            highlight(select);
+        }
+        if (type == "textlog")
+        {
+            if (!staticlayout)
+                ImGui::SetCursorPos(pos);
+            ImGui::PushID(id);
+
+            // no mouse inputs, so the viewport drags it like any other widget; it follows the tail instead
+            PreviewLog &log = Log();
+            ImGui::BeginChild(label.c_str(), ImVec2(width, size.y), true,
+                              ImGuiWindowFlags_NoMouseInputs | ImGuiWindowFlags_HorizontalScrollbar);
+            utils::ShowLines(log.text, log.lines);
+            ImGui::SetScrollHereY(1.0f);
+            ImGui::EndChild();
+
+            ImGui::PopID();
+            if ((!locked) && (utils::IsItemActiveAlt(pos, id)))
+            {
+                ImGui::SetMouseCursor(ImGuiMouseCursor_ResizeAll);
+                pos     = utils::GetLocalCursor();
+                *select = id;
+            }
+            if ((!staticlayout) && (center_h))
+            {
+                pos.x = utils::CenterHorizontal();
+            }
+            highlight(select);
+        }
+        if (IsPlot(type))
+        {
+            ImGui::PushItemWidth(width);
+            if (!staticlayout)
+                ImGui::SetCursorPos(pos);
+            ImGui::PushID(id);
+
+            const std::vector<float> &points = PreviewPlot((int)ImGui::CalcItemWidth());
+            if (type == "plotlines")
+                ImGui::PlotLines(label.c_str(), points.data(), (int)points.size(), 0, NULL, FLT_MAX, FLT_MAX,
+                                 ImVec2(0.0f, size.y));
+            else // one bar per bucket, its max
+                ImGui::PlotHistogram(label.c_str(), &points[1], (int)points.size() / 2, 0, NULL, 0.0f, FLT_MAX,
+                                     ImVec2(0.0f, size.y), sizeof(float) * 2);
+
+            ImGui::PopID();
+            ImGui::PopItemWidth();
+            if ((!locked) && (utils::IsItemActiveAlt(pos, id)))
+            {
+                ImGui::SetMouseCursor(ImGuiMouseCursor_ResizeAll);
+                pos     = utils::GetLocalCursor();
+                *select = id;
+            }
+            if ((!staticlayout) && (center_h))
+            {
+                pos.x = utils::CenterHorizontal();
+            }
+            highlight(select);
+        }
+    }
+    return edited;
+}
+
+void ImStudio::ItemList::index()
+{
+    // pasted text may end in a newline or use CRLF: neither makes an item of its own
+    items = text;
+    if (!items.empty() && (items.back() == '\n')) items.pop_back();
+    starts.clear();
+    if (items.empty()) return;
+    starts.push_back(0);
+    for (size_t n = 0; n < items.size(); n++)
+    {
+        if (items[n] != '\n') continue;
+        if ((n > 0) && (items[n - 1] == '\r')) items[n - 1] = '\0';
+        items[n] = '\0';
+        starts.push_back(static_cast<int>(n + 1));
+    }
+}
+
+// Children of a tree node, laid out under its row as TreeNode() would, and only visited while it is expanded.
+// They follow each other rather than their own positions, so a drag is not kept.
+void ImStudio::ContainerChild::drawtree(const BaseObject &node, int *select, int gen_rand, PropertyEvents *events)
+{
+    for (auto i = objects.begin(); i != objects.end(); ++i)
+    {
+        if (i->state) continue;
+        events->publish(&*i, nullptr); // deleted while collapsed as well
+        objects.erase(i);
+        break;
     }
+    if (!node.value_b) return;
+
+    static PreviewTree lazy;
+    ImGui::SetCursorScreenPos(ImVec2(ImGui::GetItemRectMin().x, ImGui::GetCursorScreenPos().y)); // under the row
+    ImGui::BeginGroup();
+    ImGui::TreePush(node.label.c_str());
+    for (BaseObject &o : objects)
+    {
+        ImVec2 pos  = o.pos;
+        ImVec2 size = o.size;
+        o.pos = ImGui::GetCursorPos();
+        bool edited = o.draw(select, gen_rand, true);
+        o.pos = pos;
+        if (edited || Moved(o, pos, size)) events->publish(&o, nullptr);
+    }
+    if (!node.value_s.empty()) lazy.draw();
+    ImGui::TreePop();
+    ImGui::EndGroup();
+}
+
+bool ImStudio::IsContainer(const std::string &type)
+{
+    return (type == "child") || (type == "treenode");
+}
+
+bool ImStudio::IsPlot(const std::string &type)
+{
+    return (type == "plotlines") || (type == "plothistogram");
+}
+
+void ImStudio::PropertyEvents::subscribe(PropertyListener listener)
+{
+    listeners.push_back(listener);
+}
+
+void ImStudio::PropertyEvents::publish(BaseObject *obj, const PropertyField *field)
+{
+    if (obj) obj->revision++;
+    revision++;
+    for (const PropertyListener &listener : listeners)
+        listener(obj, field);
+}
+
+bool ImStudio::Moved(const BaseObject &obj, ImVec2 pos, ImVec2 size)
+{
+    return (obj.pos.x != pos.x) || (obj.pos.y != pos.y) || (obj.size.x != size.x) || (obj.size.y != size.y);
 }
 
 void ImStudio::BaseObject::del()
@@ -708,7 +1063,7 @@ void ImStudio::BaseObject::highlight(int *select)
     }
 }
 
-void ImStudio::ContainerChild::drawall(int *select, int gen_rand, bool staticlayout)
+void ImStudio::ContainerChild::drawall(int *select, int gen_rand, bool staticlayout, PropertyEvents *events)
 {
     static auto dl = ImGui::GetWindowDrawList();
 
@@ -732,12 +1087,16 @@ void ImStudio::ContainerChild::drawall(int *select, int gen_rand, bool staticlay
         BaseObject &o = *i;
         if (o.state == false)
         {
+            events->publish(&o, nullptr);
             i = objects.erase(i);
             break;
         }
         else
         {
-            o.draw(select, gen_rand, staticlayout);
+            ImVec2 pos  = o.pos;
+            ImVec2 size = o.size;
+            bool edited = o.draw(select, gen_rand, staticlayout);
+            if (edited || Moved(o, pos, size)) events->publish(&o, nullptr);
         }
     }
     ImGui::EndChild();
@@ -784,3 +1143,268 @@ void ImStudio::ContainerChild::drawall(int *select, int gen_rand, bool staticlay
 
     grabinit = true;
 }
+
+namespace
+{
+    using ImStudio::BaseObject;
+    using ImStudio::PropertyField;
+    using ImStudio::ItemList;
+
+    PropertyField Gap()
+    {
+        return PropertyField();
+    }
+
+    PropertyField Text(const char *name, std::string BaseObject::*member)
+    {
+        PropertyField f;
+        f.type = ImStudio::PROP_TEXT;
+        f.name = name;
+        f.text = member;
+        return f;
+    }
+
+    PropertyField Number(const char *name, float BaseObject::*member)
+    {
+        PropertyField f;
+        f.type   = ImStudio::PROP_FLOAT;
+        f.name   = name;
+        f.number = member;
+        return f;
+    }
+
+    PropertyField Axis(const char *name, ImVec2 BaseObject::*member, int axis, bool BaseObject::*disabledby = nullptr)
+    {
+        PropertyField f;
+        f.type       = ImStudio::PROP_AXIS;
+        f.name       = name;
+        f.vec        = member;
+        f.axis       = axis;
+        f.disabledby = disabledby;
+        return f;
+    }
+
+    PropertyField Lines(const char *name, ItemList BaseObject::*member)
+    {
+        PropertyField f;
+        f.type  = ImStudio::PROP_LINES;
+        f.name  = name;
+        f.lines = member;
+        return f;
+    }
+
+    PropertyField Flag(const char *name, bool BaseObject::*member, int type = ImStudio::PROP_BOOL)
+    {
+        PropertyField f;
+        f.type = type;
+        f.name = name;
+        f.flag = member;
+        return f;
+    }
+
+    // Center/position/lock block of every freely placed widget
+    void Placement(std::vector<PropertyField> *fields, bool BaseObject::*xdisabledby = nullptr)
+    {
+        fields->push_back(Flag("Center Horizontally", &BaseObject::center_h));
+        fields->push_back(Axis("Position X", &BaseObject::pos, 0, xdisabledby));
+        fields->push_back(Axis("Position Y", &BaseObject::pos, 1));
+        fields->push_back(Flag("Drag Locked", &BaseObject::locked));
+    }
+
+    std::map<std::string, std::vector<PropertyField>> BuildSchemas()
+    {
+        std::map<std::string, std::vector<PropertyField>> schemas;
+
+        std::vector<PropertyField> &button = schemas["button"];
+        button.push_back(Text("Value", &BaseObject::value_s));
+        button.push_back(Gap());
+        Placement(&button, &BaseObject::center_h);
+        button.push_back(Gap());
+        button.push_back(Flag("Auto Resize", &BaseObject::autoresize));
+        button.push_back(Axis("Size X", &BaseObject::size, 0, &BaseObject::autoresize));
+        button.push_back(Axis("Size Y", &BaseObject::size, 1, &BaseObject::autoresize));
+
+        for (const char *kind : {"checkbox", "radio"})
+        {
+            std::vector<PropertyField> &f = schemas[kind];
+            f.push_back(Text("Label", &BaseObject::label));
+            f.push_back(Flag("Value", &BaseObject::value_b, ImStudio::PROP_BOOLCOMBO));
+            f.push_back(Gap());
+            Placement(&f);
+        }
+
+        std::vector<PropertyField> &treenode = schemas["treenode"];
+        treenode.push_back(Text("Label", &BaseObject::label));
+        treenode.push_back(Flag("Expanded", &BaseObject::value_b, ImStudio::PROP_BOOLCOMBO));
+        treenode.push_back(Text("Source", &BaseObject::value_s));
+        treenode.push_back(Gap());
+        Placement(&treenode);
+
+        std::vector<PropertyField> &image = schemas["image"];
+        image.push_back(Text("Source", &BaseObject::value_s));
+        image.push_back(Axis("Size X", &BaseObject::size, 0));
+        image.push_back(Axis("Size Y", &BaseObject::size, 1));
+        image.push_back(Gap());
+        Placement(&image);
+
+        std::vector<PropertyField> &text = schemas["text"];
+        text.push_back(Text("Value", &BaseObject::value_s));
+        text.push_back(Gap());
+        Placement(&text);
+
+        for (const char *kind : {"bullet", "arrow", "progressbar"})
+            Placement(&schemas[kind]);
+
+        std::vector<PropertyField> &color1 = schemas["color1"];
+        color1.push_back(Text("Label", &BaseObject::label));
+        color1.push_back(Gap());
+        Placement(&color1);
+
+        for (const char *kind : {"plotlines", "plothistogram", "textlog"})
+        {
+            std::vector<PropertyField> &f = schemas[kind];
+            f.push_back(Text("Label", &BaseObject::label));
+            f.push_back(Text("Source", &BaseObject::value_s));
+            f.push_back(Axis("Height", &BaseObject::size, 1));
+        }
+
+        for (const char *kind : {"combo", "listbox"})
+        {
+            std::vector<PropertyField> &f = schemas[kind];
+            f.push_back(Text("Label", &BaseObject::label));
+            f.push_back(Lines("Items", &BaseObject::itemlist));
+        }
+
+        std::vector<PropertyField> &textinput = schemas["textinput"];
+        textinput.push_back(Text("Label", &BaseObject::label));
+        textinput.push_back(Text("Value", &BaseObject::value_s));
+
+        // labelled widgets with an item width
+        for (const char *kind : {"combo", "listbox", "textinput", "inputint", "inputfloat", "inputdouble",
+                                 "inputscientific", "inputfloat3", "dragint", "dragint100", "dragfloat",
+                                 "dragfloatsmall", "sliderint", "sliderfloat", "sliderfloatlog", "sliderangle",
+                                 "color2", "color3", "plotlines", "plothistogram", "textlog"})
+        {
+            std::vector<PropertyField> &f = schemas[kind];
+            if (f.empty()) f.push_back(Text("Label", &BaseObject::label));
+            f.push_back(Gap());
+            f.push_back(Number("Width", &BaseObject::width));
+            f.push_back(Gap());
+            Placement(&f);
+        }
+
+        // widgets with state: bound to a field of the user's data struct, the generated code edits that field
+        for (const char *kind : {"checkbox", "radio", "combo", "listbox", "textinput", "inputint", "inputfloat",
+                                 "inputdouble", "inputscientific", "inputfloat3", "dragint", "dragint100", "dragfloat",
+                                 "dragfloatsmall", "sliderint", "sliderfloat", "sliderfloatlog", "sliderangle",
+                                 "color1", "color2", "color3", "progressbar"})
+        {
+            std::vector<PropertyField> &f = schemas[kind];
+            f.push_back(Gap());
+            f.push_back(Text("Bind", &BaseObject::binding));
+        }
+        return schemas;
+    }
+}
+
+const std::vector<ImStudio::PropertyField> &ImStudio::PropertySchema(const std::string &type)
+{
+    static const std::map<std::string, std::vector<PropertyField>> schemas = BuildSchemas();
+    static const std::vector<PropertyField> none;
+    auto found = schemas.find(type);
+    return (found != schemas.end()) ? found->second : none;
+}
+
+bool ImStudio::SameProperty(const BaseObject &a, const BaseObject &b, const PropertyField &f)
+{
+    switch (f.type)
+    {
+    case PROP_TEXT:      return a.*f.text == b.*f.text;
+    case PROP_FLOAT:     return a.*f.number == b.*f.number;
+    case PROP_AXIS:      return f.axis ? ((a.*f.vec).y == (b.*f.vec).y) : ((a.*f.vec).x == (b.*f.vec).x);
+    case PROP_BOOL:
+    case PROP_BOOLCOMBO: return a.*f.flag == b.*f.flag;
+    case PROP_LINES:     return (a.*f.lines).text == (b.*f.lines).text;
+    }
+    return true;
+}
+
+bool ImStudio::SetProperty(BaseObject *dst, const BaseObject &src, const PropertyField &f, PropertyEvents *events)
+{
+    if (SameProperty(*dst, src, f)) return false;
+    CopyProperty(dst, src, f);
+    events->publish(dst, &f);
+    return true;
+}
+
+void ImStudio::CopyProperty(BaseObject *dst, const BaseObject &src, const PropertyField &f)
+{
+    switch (f.type)
+    {
+    case PROP_TEXT:      dst->*f.text = src.*f.text; break;
+    case PROP_FLOAT:     dst->*f.number = src.*f.number; break;
+    case PROP_AXIS:      if (f.axis) (dst->*f.vec).y = (src.*f.vec).y; else (dst->*f.vec).x = (src.*f.vec).x; break;
+    case PROP_BOOL:
+    case PROP_BOOLCOMBO: dst->*f.flag = src.*f.flag; break;
+    case PROP_LINES:     dst->*f.lines = src.*f.lines; break;
+    }
+}
+
+bool ImStudio::EditProperties(const std::vector<BaseObject *> &targets, PropertyEvents *events)
+{
+    static const char *boolitems[] = {"False", "True"};
+    BaseObject &obj = *targets[0];
+    bool changed = false;
+
+    ImGui::PushID(obj.id); // keeps text edit state from carrying over to the next selected object
+    for (const PropertyField &f : PropertySchema(obj.type))
+    {
+        bool disabled = f.disabledby && (obj.*f.disabledby);
+        if (disabled) ImGui::BeginDisabled(true);
+
+        bool edited = false;
+        switch (f.type)
+        {
+        case PROP_GAP:
+            ImGui::NewLine();
+            break;
+        case PROP_TEXT:
+            edited = ImGui::InputText(f.name, &(obj.*f.text));
+            break;
+        case PROP_FLOAT:
+            edited = ImGui::InputFloat(f.name, &(obj.*f.number), f.step, f.stepfast, "%.3f");
+            break;
+        case PROP_AXIS:
+            edited = ImGui::InputFloat(f.name, f.axis ? &(obj.*f.vec).y : &(obj.*f.vec).x, f.step, f.stepfast, "%.3f");
+            break;
+        case PROP_BOOL:
+            edited = ImGui::Checkbox(f.name, &(obj.*f.flag));
+            break;
+        case PROP_BOOLCOMBO:
+        {
+            int cur = (obj.*f.flag) ? 1 : 0;
+            edited  = ImGui::Combo(f.name, &cur, boolitems, IM_ARRAYSIZE(boolitems)) && ((cur != 0) != obj.*f.flag);
+            obj.*f.flag = (cur != 0);
+            break;
+        }
+        case PROP_LINES:
+        {
+            // one item per line: Ctrl+V pastes a whole column at once
+            ItemList &list = obj.*f.lines;
+            edited = ImGui::InputTextMultiline(f.name, &list.text, ImVec2(0.0f, ImGui::GetTextLineHeight() * 8));
+            if (edited) list.index();
+            ImGui::TextDisabled("%d items", list.count());
+            break;
+        }
+        }
+
+        if (disabled) ImGui::EndDisabled();
+        if (!edited) continue;
+        changed = true;
+        events->publish(&obj, &f);
+        for (size_t i = 1; i < targets.size(); i++)
+            SetProperty(targets[i], obj, f, events);
+    }
+    ImGui::PopID();
+    return changed;
+}
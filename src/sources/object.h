@@ -3,10 +3,26 @@
 
 #include "../includes.h"
 
+#include <functional>
+
 namespace ImStudio
 {
 
   class Object;
+
+  // Items of a combo/listbox, one per line as edited. index() turns the text into NUL-terminated items and their
+  // offsets once per edit, so drawing a list only touches the items on screen.
+  struct ItemList
+  {
+      std::string             text                    = "Never\nGonna\nGive\nYou\nUp";
+      std::string             items                   = {};                   // text, line ends as '\0'
+      std::vector<int>        starts                  = {};                   // Offset of every item in items
+
+      ItemList                ()                      { index(); }
+      void index              ();
+      int  count              () const                { return static_cast<int>(starts.size()); }
+      const char *operator[]  (int n) const           { return items.c_str() + starts[n]; }
+  };
   
   class BaseObject
   {
@@ -32,6 +48,7 @@ namespace ImStudio
       std::string             label                   = "Label";              //--
       std::string             value_s                 = {};                   //  | Widget values/contents
       bool                    value_b                 = false;                //--
+      std::string             binding                 = {};                   // Data struct field (generated code)
   
       Object*                 parent                  = nullptr;              //--
       //int                     parentid                = 0;                  //  | For child objects and
@@ -39,8 +56,10 @@ namespace ImStudio
       bool                    ischildwidget           = false;                //--
   
       int                     item_current            = 0;                    //
+      ItemList                itemlist                = {};                   // Combo/listbox items
+      unsigned                revision                = 0;                    // Bumped by every change
   
-      void draw               (int *select,           int gen_rand,           bool staticlayout);
+      bool draw               (int *select,           int gen_rand,           bool staticlayout); // Edited in the preview
       void del                ();
   
       BaseObject              ()                      = default;
@@ -50,6 +69,26 @@ namespace ImStudio
       void highlight          (int *select);
   };
   
+  struct PropertyField;
+
+  // Change notifications of one design. Listeners get (object, field) for every real change; field is null for
+  // changes made outside the property editor (drag, auto resize, create, delete) and object is null for changes
+  // to the window itself.
+  typedef std::function<void(BaseObject *, const PropertyField *)> PropertyListener;
+
+  struct PropertyEvents
+  {
+      unsigned                revision                = 0;                    // Bumped by every change
+      std::vector<PropertyListener> listeners         = {};
+
+      void subscribe          (PropertyListener listener);
+      void publish            (BaseObject *obj,       const PropertyField *field);
+  };
+
+  bool Moved              (const BaseObject &obj, ImVec2 pos,             ImVec2 size);   // Differs from a snapshot
+  bool IsPlot             (const std::string &type);                                      // plotlines/plothistogram
+  bool IsContainer        (const std::string &type);                                      // child/treenode, has child.objects
+
   struct ContainerChild
   {
       int                     id                      = 0;                    // Unique ID
@@ -69,7 +108,8 @@ namespace ImStudio
       bool                    grabinit                = false;                //--
       
       std::vector<BaseObject> objects                 = {};
-      void drawall            (int *select,           int gen_rand,           bool staticlayout);  
+      void drawall            (int *select,           int gen_rand,           bool staticlayout,      PropertyEvents *events);
+      void drawtree           (const BaseObject &node, int *select,           int gen_rand,           PropertyEvents *events);
   };
   
   //Object can now store either a single BaseObject or a vector of BaseObjects
@@ -82,4 +122,38 @@ namespace ImStudio
       Object                  (int idvar_, std::string type_);
   };
 
+  enum PropertyType
+  {
+      PROP_GAP,                                                                   // Blank line between groups
+      PROP_TEXT,                                                                  // std::string
+      PROP_FLOAT,                                                                 // float
+      PROP_AXIS,                                                                  // ImVec2 component
+      PROP_BOOL,                                                                  // bool, checkbox
+      PROP_BOOLCOMBO,                                                             // bool, False/True combo
+      PROP_LINES                                                                  // ItemList, one item per line
+  };
+
+  // One editable field of a widget kind. The member pointers are the typed form of a field offset, so the editor,
+  // copy and compare all go through the same table.
+  struct PropertyField
+  {
+      int                     type                    = PROP_GAP;             // PropertyType
+      const char *            name                    = "";                   // Editor label
+      std::string BaseObject::*text                   = nullptr;              // PROP_TEXT
+      float BaseObject::*     number                  = nullptr;              // PROP_FLOAT
+      ImVec2 BaseObject::*    vec                     = nullptr;              //-- PROP_AXIS
+      int                     axis                    = 0;                    //--
+      bool BaseObject::*      flag                    = nullptr;              // PROP_BOOL/PROP_BOOLCOMBO
+      ItemList BaseObject::*  lines                   = nullptr;              // PROP_LINES
+      bool BaseObject::*      disabledby              = nullptr;              // Greyed out while set
+      float                   step                    = 1.0f;                 //-- PROP_FLOAT/PROP_AXIS
+      float                   stepfast                = 10.0f;                //--
+  };
+
+  const std::vector<PropertyField> &PropertySchema(const std::string &type);  // Fields of a widget kind
+  bool SameProperty       (const BaseObject &a,   const BaseObject &b,    const PropertyField &f);
+  void CopyProperty       (BaseObject *dst,       const BaseObject &src,  const PropertyField &f);
+  bool SetProperty        (BaseObject *dst,       const BaseObject &src,  const PropertyField &f,     PropertyEvents *events);
+  bool EditProperties     (const std::vector<BaseObject *> &targets,      PropertyEvents *events); // Edits targets[0], changes go to all
+
 }
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include "../includes.h"
+#include "FileWatch.h"
+
+#include <chrono>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+namespace
+{
+    long long ModifiedTime(const std::string &path)
+    {
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0) return 0;
+        return static_cast<long long>(st.st_mtime) * 1000000000LL + static_cast<long long>(st.st_size);
+    }
+
+    double Seconds()
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+utils::FileWatch::~FileWatch()
+{
+    stop();
+}
+
+bool utils::FileWatch::watch(const std::string &file)
+{
+    stop();
+    size_t      slash = file.find_last_of("/\\");
+    std::string dir   = (slash == std::string::npos) ? "." : file.substr(0, slash);
+    name    = (slash == std::string::npos) ? file : file.substr(slash + 1);
+    path    = file;
+    mtime   = ModifiedTime(file);
+    checked = Seconds();
+#ifdef __linux__
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd >= 0) wd = inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if ((fd >= 0) && (wd < 0))
+    {
+        close(fd);
+        fd = -1;
+    }
+#endif
+    return active();
+}
+
+void utils::FileWatch::stop()
+{
+#ifdef __linux__
+    if (fd >= 0) close(fd);
+#endif
+    fd = -1;
+    wd = -1;
+    path.clear();
+}
+
+bool utils::FileWatch::changed()
+{
+    if (!active()) return false;
+#ifdef __linux__
+    if (fd >= 0)
+    {
+        // drain everything queued; several writes in one frame are one change
+        bool hit = false;
+        alignas(inotify_event) char buf[4096];
+        for (;;)
+        {
+            ssize_t len = read(fd, buf, sizeof(buf));
+            if (len <= 0) break;
+            for (char *p = buf; p < buf + len;)
+            {
+                const inotify_event *ev = reinterpret_cast<const inotify_event *>(p);
+                if ((ev->len > 0) && (name == ev->name)) hit = true;
+                p += sizeof(inotify_event) + ev->len;
+            }
+        }
+        return hit;
+    }
+#endif
+    double now = Seconds();
+    if (now - checked < 1.0) return false;
+    checked = now;
+    long long t = ModifiedTime(path);
+    if (t == mtime) return false;
+    mtime = t;
+    return true;
+}
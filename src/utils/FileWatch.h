@@ -0,0 +1,29 @@
+#pragma once
+
+#include "../includes.h"
+
+namespace utils
+{
+
+    // Reports changes to one file without blocking. On Linux it is an inotify watch on the file's directory, so
+    // editors and scripts that replace the file by a rename are seen too; elsewhere the modification time is polled
+    // once a second.
+    class FileWatch
+    {
+      public:
+                       ~FileWatch                     ();
+        bool           watch                          (const std::string &path);      // Replaces the previous watch
+        void           stop                           ();
+        bool           changed                        ();                             // Since the last call, once per frame
+        bool           active                         () const { return !path.empty(); }
+
+      private:
+        std::string    path                           = {};
+        std::string    name                           = {};                           // File name within its directory
+        int            fd                             = -1;                           //-- inotify
+        int            wd                             = -1;                           //--
+        long long      mtime                          = 0;                            //-- Polling fallback
+        double         checked                        = 0.0;                          //--
+    };
+
+}
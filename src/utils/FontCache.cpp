@@ -0,0 +1,206 @@
+#include "../includes.h"
+#include "FontCache.h"
+
+namespace
+{
+    const char     magic[8] = {'I', 'M', 'S', 'F', 'O', 'N', 'T', '1'};
+
+    struct CacheHeader
+    {
+        char                    magic[8];
+        ImGuiID                 key;                                               // AtlasKey() of the fonts
+        int                     width;                                             //--
+        int                     height;                                            //  | Texture
+        ImVec2                  uvscale;                                           //  |
+        ImVec2                  uvwhite;                                           //--
+        ImVec4                  uvlines[IM_DRAWLIST_TEX_LINES_WIDTH_MAX + 1];      // Baked line UVs
+        int                     rects;                                             // Custom rects (x, y each)
+        int                     fonts;                                             // Font records
+    };
+
+    struct FontRecord
+    {
+        float                   ascent;
+        float                   descent;
+        int                     glyphs;                                            // ImFontGlyph count that follows
+    };
+
+    ImGuiID HashValue(ImGuiID seed, const void *data, size_t size)
+    {
+        return ImHashData(data, size, seed);
+    }
+
+    template <typename T> ImGuiID HashValue(ImGuiID seed, const T &value)
+    {
+        return ImHashData(&value, sizeof(T), seed);
+    }
+
+    // Everything the stb_truetype builder output depends on
+    ImGuiID AtlasKey(const ImFontAtlas *atlas)
+    {
+        ImGuiID key = HashValue(0, IMGUI_VERSION_NUM);
+        key = HashValue(key, atlas->Flags);
+        key = HashValue(key, atlas->TexDesiredWidth);
+        key = HashValue(key, atlas->TexGlyphPadding);
+        for (const ImFontAtlasCustomRect &r : atlas->CustomRects)
+        {
+            key = HashValue(key, r.Width);
+            key = HashValue(key, r.Height);
+        }
+        for (const ImFontConfig &cfg : atlas->ConfigData)
+        {
+            key = HashValue(key, cfg.FontData, (size_t)cfg.FontDataSize);
+            key = HashValue(key, cfg.FontNo);
+            key = HashValue(key, cfg.SizePixels);
+            key = HashValue(key, cfg.OversampleH);
+            key = HashValue(key, cfg.OversampleV);
+            key = HashValue(key, cfg.PixelSnapH);
+            key = HashValue(key, cfg.GlyphExtraSpacing);
+            key = HashValue(key, cfg.GlyphOffset);
+            key = HashValue(key, cfg.GlyphMinAdvanceX);
+            key = HashValue(key, cfg.GlyphMaxAdvanceX);
+            key = HashValue(key, cfg.MergeMode);
+            key = HashValue(key, cfg.FontBuilderFlags);
+            key = HashValue(key, cfg.RasterizerMultiply);
+            key = HashValue(key, cfg.EllipsisChar);
+            for (const ImWchar *range = cfg.GlyphRanges; range && range[0]; range += 2)
+            {
+                key = HashValue(key, range[0]);
+                key = HashValue(key, range[1]);
+            }
+            int font = atlas->Fonts.index_from_ptr(std::find(atlas->Fonts.begin(), atlas->Fonts.end(), cfg.DstFont));
+            key = HashValue(key, font);
+        }
+        return key;
+    }
+
+    bool ReadFile(const char *path, std::vector<char> *data)
+    {
+        FILE *fp = fopen(path, "rb");
+        if (!fp) return false;
+        fseek(fp, 0, SEEK_END);
+        long size = ftell(fp);
+        fseek(fp, 0, SEEK_SET);
+        bool ok = (size > 0);
+        if (ok)
+        {
+            data->resize((size_t)size);
+            ok = fread(data->data(), 1, data->size(), fp) == data->size();
+        }
+        fclose(fp);
+        return ok;
+    }
+
+    // Checks the whole file against the atlas before touching it, then sets it up as ImFontAtlasBuildFinish() would
+    bool LoadAtlas(ImFontAtlas *atlas, const char *path, ImGuiID key)
+    {
+        std::vector<char> data;
+        if (!ReadFile(path, &data) || (data.size() < sizeof(CacheHeader))) return false;
+
+        CacheHeader header;
+        memcpy(&header, data.data(), sizeof(header));
+        if ((memcmp(header.magic, magic, sizeof(magic)) != 0) || (header.key != key)) return false;
+        if ((header.rects != atlas->CustomRects.Size) || (header.fonts != atlas->Fonts.Size)) return false;
+        if ((header.width <= 0) || (header.height <= 0)) return false;
+
+        size_t at = sizeof(header) + sizeof(unsigned short) * 2 * header.rects;
+        std::vector<FontRecord> fonts(header.fonts);
+        std::vector<size_t>     glyphs(header.fonts);
+        for (int i = 0; i < header.fonts; i++)
+        {
+            if (at + sizeof(FontRecord) > data.size()) return false;
+            memcpy(&fonts[i], data.data() + at, sizeof(FontRecord));
+            at       += sizeof(FontRecord);
+            glyphs[i] = at;
+            at       += sizeof(ImFontGlyph) * fonts[i].glyphs;
+        }
+        size_t pixels = (size_t)header.width * header.height;
+        if (at + pixels != data.size()) return false;
+
+        atlas->ClearTexData();
+        atlas->TexWidth        = header.width;
+        atlas->TexHeight       = header.height;
+        atlas->TexUvScale      = header.uvscale;
+        atlas->TexUvWhitePixel = header.uvwhite;
+        memcpy(atlas->TexUvLines, header.uvlines, sizeof(header.uvlines));
+        atlas->TexPixelsAlpha8 = (unsigned char *)IM_ALLOC(pixels);
+        memcpy(atlas->TexPixelsAlpha8, data.data() + at, pixels);
+
+        const char *rect = data.data() + sizeof(header);
+        for (ImFontAtlasCustomRect &r : atlas->CustomRects)
+        {
+            memcpy(&r.X, rect, sizeof(unsigned short));
+            memcpy(&r.Y, rect + sizeof(unsigned short), sizeof(unsigned short));
+            rect += sizeof(unsigned short) * 2;
+        }
+
+        for (ImFontConfig &cfg : atlas->ConfigData)
+        {
+            int font = atlas->Fonts.index_from_ptr(std::find(atlas->Fonts.begin(), atlas->Fonts.end(), cfg.DstFont));
+            ImFontAtlasBuildSetupFont(atlas, cfg.DstFont, &cfg, fonts[font].ascent, fonts[font].descent);
+        }
+        for (int i = 0; i < header.fonts; i++)
+        {
+            ImFont *font = atlas->Fonts[i];
+            font->Glyphs.resize(fonts[i].glyphs);
+            if (fonts[i].glyphs > 0)
+                memcpy(font->Glyphs.Data, data.data() + glyphs[i], sizeof(ImFontGlyph) * fonts[i].glyphs);
+            font->BuildLookupTable();
+        }
+        atlas->TexReady = true;
+        return true;
+    }
+
+    void SaveAtlas(const ImFontAtlas *atlas, const char *path, ImGuiID key)
+    {
+        if (!atlas->TexPixelsAlpha8) return;
+
+        CacheHeader header;
+        memcpy(header.magic, magic, sizeof(magic));
+        header.key     = key;
+        header.width   = atlas->TexWidth;
+        header.height  = atlas->TexHeight;
+        header.uvscale = atlas->TexUvScale;
+        header.uvwhite = atlas->TexUvWhitePixel;
+        memcpy(header.uvlines, atlas->TexUvLines, sizeof(header.uvlines));
+        header.rects   = atlas->CustomRects.Size;
+        header.fonts   = atlas->Fonts.Size;
+
+        FILE *fp = fopen(path, "wb");
+        if (!fp) return;
+        bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+        for (const ImFontAtlasCustomRect &r : atlas->CustomRects)
+        {
+            ok = ok && (fwrite(&r.X, sizeof(unsigned short), 1, fp) == 1);
+            ok = ok && (fwrite(&r.Y, sizeof(unsigned short), 1, fp) == 1);
+        }
+        for (const ImFont *font : atlas->Fonts)
+        {
+            FontRecord record;
+            record.ascent  = font->Ascent;
+            record.descent = font->Descent;
+            record.glyphs  = font->Glyphs.Size;
+            ok = ok && (fwrite(&record, sizeof(record), 1, fp) == 1);
+            if (record.glyphs > 0)
+                ok = ok && (fwrite(font->Glyphs.Data, sizeof(ImFontGlyph), font->Glyphs.Size, fp) == (size_t)font->Glyphs.Size);
+        }
+        size_t pixels = (size_t)atlas->TexWidth * atlas->TexHeight;
+        ok = ok && (fwrite(atlas->TexPixelsAlpha8, 1, pixels, fp) == pixels);
+        ok = (fclose(fp) == 0) && ok;
+        if (!ok) remove(path); // never leave a truncated cache behind
+    }
+}
+
+bool utils::BuildFontsCached(ImFontAtlas *atlas, const char *path)
+{
+    if (atlas->ConfigData.Size == 0)
+        atlas->AddFontDefault();
+    ImFontAtlasBuildInit(atlas); // default custom rects, so they are part of the key
+
+    ImGuiID key = AtlasKey(atlas);
+    if (LoadAtlas(atlas, path, key)) return true;
+
+    atlas->Build();
+    SaveAtlas(atlas, path, key);
+    return false;
+}
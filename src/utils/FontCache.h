@@ -0,0 +1,12 @@
+#pragma once
+
+#include "../includes.h"
+
+namespace utils
+{
+
+    // Builds io.Fonts through a cache file holding the baked atlas (pixels, glyphs, metrics). The file is keyed by the
+    // ImGui version, the font data, sizes, glyph ranges and build flags; a warm launch skips rasterization.
+    bool           BuildFontsCached               (ImFontAtlas *atlas, const char *path);   // true on a cache hit
+
+}
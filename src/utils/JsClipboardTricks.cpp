@@ -24,9 +24,11 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 #include "imgui.h"
+#include "imgui_internal.h"
 #include "JsClipboardTricks.h"
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
+#include <string.h>
 
 // The clipboard handling features take inspiration from sokol
 // https://github.com/floooh/sokol
@@ -91,10 +93,44 @@ extern "C"
 #endif
 
 #ifdef IMGUIMANUAL_CLIPBOARD_EXPORT_TO_BROWSER
+    namespace
+    {
+        void   (*backend_set_clipboard)(void*, const char*) = NULL;
+        size_t pushed_size = (size_t)-1;
+        ImGuiID pushed_hash = 0;
+        double pushed_time = -1.0;
+
+        void ExportClipboardText(void* user_data, const char* str)
+        {
+            if (backend_set_clipboard)
+                backend_set_clipboard(user_data, str);
+            JsClipboard_SetClipboardText(str);
+        }
+    }
+
     void JsClipboard_SetClipboardText(const char* str)
     {
+        // Ctrl+C held in a text field repeats the same copy: push a text again only once it changed or a second
+        // went by (the browser clipboard may have changed outside in between)
+        size_t size = strlen(str);
+        ImGuiID hash = ImHashData(str, size);
+        double now = ImGui::GetTime();
+        if (size == pushed_size && hash == pushed_hash && now - pushed_time < 1.0)
+            return;
+        pushed_size = size;
+        pushed_hash = hash;
+        pushed_time = now;
         sapp_js_write_clipboard(str);
     }
+
+    void JsClipboard_InstallExportHook()
+    {
+        ImGuiIO& io = ImGui::GetIO();
+        if (io.SetClipboardTextFn == ExportClipboardText)
+            return;
+        backend_set_clipboard = io.SetClipboardTextFn;
+        io.SetClipboardTextFn = ExportClipboardText;
+    }
 #endif
 
 #ifdef IMGUIMANUAL_CLIPBOARD_IMPORT_FROM_BROWSER
@@ -36,6 +36,9 @@ SOFTWARE.
 
 #ifdef IMGUIMANUAL_CLIPBOARD_EXPORT_TO_BROWSER
 void JsClipboard_SetClipboardText(const char* str);
+// Chains io.SetClipboardTextFn so every ImGui copy (LogToClipboard, Ctrl+C in a text field) also reaches the
+// browser, once, when it happens. Call after the platform backend has set its own function.
+void JsClipboard_InstallExportHook();
 #endif
 
 #ifdef IMGUIMANUAL_CLIPBOARD_IMPORT_FROM_BROWSER
@@ -1,6 +1,25 @@
 #include "../includes.h"
 #include "utils.h"
 
+#include <chrono>
+
+namespace
+{
+    typedef std::chrono::steady_clock startup_clock;
+
+    struct StartupMark
+    {
+        const char *            name;
+        double                  ms;                                                // Since the previous mark
+    };
+
+    typedef startup_clock::time_point startup_time;
+
+    const startup_time          startup_origin = startup_clock::now();             // Static init, before main()
+    startup_time                startup_last   = startup_origin;
+    std::vector<StartupMark>    startup_marks;
+}
+
 ImVec2 utils::GetLocalCursor()
 {
     ImGuiIO &     io         = ImGui::GetIO();
@@ -314,6 +333,11 @@ void utils::ShowAboutWindow(bool *child_about)
             ImGui::Text("ImGui: 18500 (55d35d8)");
             ImGui::Text("Fmt: 8.0.1 (d141cdb)");
             ImGui::Separator();
+            if (!startup_marks.empty())
+            {
+                ImGui::TextUnformatted(StartupReport().c_str());
+                ImGui::Separator();
+            }
 
             if (ImGui::Button("Back")) { ImGui::CloseCurrentPopup(); *child_about = false; }
             ImGui::EndPopup();
@@ -370,3 +394,84 @@ float utils::CenterHorizontal()
     float PosX = ((windowWidth - itemWidth) * 0.5f);
     return PosX;
 }
+
+void utils::StartupPhase(const char *name)
+{
+    startup_time now = startup_clock::now();
+    StartupMark mark;
+    mark.name    = name;
+    mark.ms      = std::chrono::duration<double, std::milli>(now - startup_last).count();
+    startup_last = now;
+    startup_marks.push_back(mark);
+}
+
+std::string utils::StartupReport()
+{
+    std::string report;
+    for (const StartupMark &mark : startup_marks)
+        report += fmt::format("{:<16}{:>9.2f} ms\n", mark.name, mark.ms);
+    double total = std::chrono::duration<double, std::milli>(startup_last - startup_origin).count();
+    report += fmt::format("{:<16}{:>9.2f} ms", "total", total);
+    return report;
+}
+
+// Splits values into buckets of (almost) equal size and keeps the extremes of each, so a plot of 2 * buckets points
+// shows every spike of the full series. Eight independent lanes per bucket keep the inner loop branch free and let
+// the compiler turn it into packed min/max; the generated code carries a copy (see PlotHelper() in generator.cpp).
+void utils::DecimateMinMax(const float *values, int count, int buckets, float *out)
+{
+    for (int b = 0; b < buckets; b++)
+    {
+        int begin = (int)((long long)count * b / buckets);
+        int end   = (int)((long long)count * (b + 1) / buckets);
+        float lo[8], hi[8];
+        for (int k = 0; k < 8; k++) lo[k] = hi[k] = values[begin];
+        int i = begin;
+        for (; i + 8 <= end; i += 8)
+        {
+            for (int k = 0; k < 8; k++)
+            {
+                lo[k] = (values[i + k] < lo[k]) ? values[i + k] : lo[k];
+                hi[k] = (values[i + k] > hi[k]) ? values[i + k] : hi[k];
+            }
+        }
+        for (; i < end; i++)
+        {
+            lo[0] = (values[i] < lo[0]) ? values[i] : lo[0];
+            hi[0] = (values[i] > hi[0]) ? values[i] : hi[0];
+        }
+        for (int k = 1; k < 8; k++)
+        {
+            lo[0] = (lo[k] < lo[0]) ? lo[k] : lo[0];
+            hi[0] = (hi[k] > hi[0]) ? hi[k] : hi[0];
+        }
+        out[b * 2]     = lo[0];
+        out[b * 2 + 1] = hi[0];
+    }
+}
+
+// Appends to a text kept with the offset of every line start. Only the added bytes are scanned, so appending costs
+// the same at 10 MB as at 10 KB; the generated code carries a copy (see LogHelper() in generator.cpp).
+void utils::AppendLines(ImGuiTextBuffer *text, ImVector<int> *lines, const char *begin, const char *end)
+{
+    int old = text->size();
+    if (lines->Size == 0) lines->push_back(0);
+    text->append(begin, end);
+    for (const char *c = text->begin() + old; (c = (const char *)memchr(c, '\n', text->end() - c)) != NULL; c++)
+        lines->push_back((int)(c - text->begin()) + 1);
+}
+
+// Submits the lines of an AppendLines() text that are in view, rather than one TextUnformatted() over all of it
+void utils::ShowLines(const ImGuiTextBuffer &text, const ImVector<int> &lines)
+{
+    ImGuiListClipper clipper;
+    clipper.Begin(lines.Size);
+    while (clipper.Step())
+    {
+        for (int n = clipper.DisplayStart; n < clipper.DisplayEnd; n++)
+        {
+            const char *end = (n + 1 < lines.Size) ? text.begin() + lines[n + 1] - 1 : text.end();
+            ImGui::TextUnformatted(text.begin() + lines[n], end);
+        }
+    }
+}
@@ -18,5 +18,10 @@ namespace utils
     bool           GrabButton                     (ImVec2 pos, int random_int);
     void           HelpMarker                     (const char *desc);
     float          CenterHorizontal               ();
+    void           StartupPhase                   (const char *name);                     // closes the phase running since the last mark
+    std::string    StartupReport                  ();
+    void           DecimateMinMax                 (const float *values, int count, int buckets, float *out); // out: (min, max) per bucket
+    void           AppendLines                    (ImGuiTextBuffer *text, ImVector<int> *lines, const char *begin, const char *end = NULL);
+    void           ShowLines                      (const ImGuiTextBuffer &text, const ImVector<int> &lines); // visible ones only
 
 }
\ No newline at end of file